@@ -0,0 +1,89 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_BENCHMARK_HPP
+#define CHEMFILES_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+//! Run \c function \c repeat times, and return the minimal time of all the
+//! runs in seconds.
+template <class Function>
+double run(Function function, size_t repeat = 5) {
+    auto best = std::chrono::duration<double>::max();
+    for (size_t i=0; i<repeat; i++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start));
+    }
+    return best.count();
+}
+
+//! Get the size in bytes of the file at \c path
+inline double file_size(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg());
+}
+
+//! Print the result of a benchmark as a line of tab separated values:
+//! the benchmark name, the size of the problem, the time in seconds and an
+//! optional throughput.
+inline void report(const std::string& name, size_t size, double time,
+                   const std::string& throughput = "") {
+    std::cout << name << '\t' << size << '\t'
+              << std::scientific << std::setprecision(3) << time;
+    if (!throughput.empty()) {
+        std::cout << '\t' << throughput;
+    }
+    std::cout << std::endl;
+}
+
+//! Print the size of some output of a benchmark as a line of tab separated
+//! values: the benchmark name, the size of the problem, the output size in
+//! bytes followed by the `B` unit and an optional comment.
+inline void report_size(const std::string& name, size_t size, double bytes,
+                        const std::string& comment = "") {
+    std::cout << name << '\t' << size << '\t'
+              << std::fixed << std::setprecision(0) << bytes << " B";
+    if (!comment.empty()) {
+        std::cout << '\t' << comment;
+    }
+    std::cout << std::endl;
+}
+
+//! Format a throughput of \c count items of kind \c unit in \c time seconds
+inline std::string throughput(double count, double time, const std::string& unit) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2) << count / time << " " << unit << "/s";
+    return stream.str();
+}
+
+//! Prevent the compiler from optimizing away the computation of \c value
+template <class T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace benchmark
+
+#endif
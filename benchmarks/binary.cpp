@@ -0,0 +1,66 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the throughput of the chemfiles binary format, when writing,
+// reading sequentially and reading frames in a random order.
+
+#include <cstdio>
+#include <initializer_list>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+static const char* FILENAME = "benchmark-binary.chfl";
+static const size_t NSTEPS = 100;
+
+int main() {
+    for (auto natoms: std::initializer_list<size_t>{10, 1000, 100000, 1000000}) {
+        Frame frame(natoms);
+        frame.cell(UnitCell(50, 60, 70));
+        for (size_t i=0; i<natoms; i++) {
+            frame.positions()[i] = Vector3D(
+                static_cast<float>(i % 50), static_cast<float>(i % 60), static_cast<float>(i % 70)
+            );
+        }
+        auto megabytes = static_cast<double>(NSTEPS * natoms * 3 * sizeof(float)) / (1024 * 1024);
+
+        auto time = benchmark::run([&frame](){
+            Trajectory file(FILENAME, "w");
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame.step(step);
+                file << frame;
+            }
+        });
+        benchmark::report("binary/write", natoms, time / NSTEPS,
+                          benchmark::throughput(megabytes, time, "MB"));
+
+        time = benchmark::run([&frame](){
+            Trajectory file(FILENAME);
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame = file.read();
+            }
+            benchmark::do_not_optimize(frame);
+        });
+        benchmark::report("binary/read", natoms, time / NSTEPS,
+                          benchmark::throughput(megabytes, time, "MB"));
+
+        time = benchmark::run([&frame](){
+            Trajectory file(FILENAME);
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame = file.read_step((step * 37) % NSTEPS);
+            }
+            benchmark::do_not_optimize(frame);
+        });
+        benchmark::report("binary/read-step", natoms, time / NSTEPS,
+                          benchmark::throughput(megabytes, time, "MB"));
+    }
+
+    std::remove(FILENAME);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the lossy compression of positions: compression ratio and
+// encoding/decoding throughput of the codec, and writing/reading throughput
+// of compressed chemfiles binary files compared to uncompressed ones.
+
+#include <cstdio>
+#include <iomanip>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+#include "chemfiles/Codec.hpp"
+using namespace chemfiles;
+
+static const char* FILENAME = "benchmark-codec.chfl";
+static const size_t NSTEPS = 100;
+static const double PRECISION = 1e-3;
+
+static std::string ratio(double size, double raw_size) {
+    std::ostringstream output;
+    output << std::fixed << std::setprecision(3) << size / raw_size << " of raw size";
+    return output.str();
+}
+
+// Generate NSTEPS frames of \c natoms atoms doing a random walk in a box
+static std::vector<Array3D> random_walk(size_t natoms) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> positions(0, 50);
+    std::normal_distribution<float> moves(0, 0.05f);
+
+    std::vector<Array3D> steps(NSTEPS, Array3D(natoms));
+    for (auto& vector: steps[0]) {
+        vector = Vector3D(positions(random), positions(random), positions(random));
+    }
+    for (size_t step=1; step<NSTEPS; step++) {
+        for (size_t i=0; i<natoms; i++) {
+            steps[step][i] = steps[step - 1][i] + Vector3D(moves(random), moves(random), moves(random));
+        }
+    }
+    return steps;
+}
+
+static void benchmark_codec(const std::vector<Array3D>& steps, size_t natoms) {
+    auto raw_size = static_cast<double>(NSTEPS * natoms * 3 * sizeof(float));
+    auto gigabytes = raw_size / (1024 * 1024 * 1024);
+
+    std::vector<std::vector<char>> encoded(NSTEPS);
+    auto time = benchmark::run([&](){
+        LossyCodec codec(PRECISION);
+        for (size_t step=0; step<NSTEPS; step++) {
+            encoded[step].clear();
+            codec.encode(steps[step], step % 32 == 0, encoded[step]);
+        }
+    });
+    benchmark::report("codec/encode", natoms, time / NSTEPS, benchmark::throughput(gigabytes, time, "GB"));
+
+    double size = 0;
+    for (auto& data: encoded) {
+        size += static_cast<double>(data.size());
+    }
+    benchmark::report_size("codec/size", natoms, size, ratio(size, raw_size));
+
+    Array3D decoded;
+    time = benchmark::run([&](){
+        LossyCodec codec(PRECISION);
+        for (size_t step=0; step<NSTEPS; step++) {
+            codec.decode(encoded[step].data(), encoded[step].size(), step % 32 == 0, decoded);
+        }
+        benchmark::do_not_optimize(decoded);
+    });
+    benchmark::report("codec/decode", natoms, time / NSTEPS, benchmark::throughput(gigabytes, time, "GB"));
+}
+
+// Write and read the steps in a chemfiles binary file with the given
+// precision, 0 meaning without compression.
+static void benchmark_binary(const std::vector<Array3D>& steps, size_t natoms, double precision) {
+    auto raw_size = static_cast<double>(NSTEPS * natoms * 3 * sizeof(float));
+    auto megabytes = raw_size / (1024 * 1024);
+    std::string name = precision == 0 ? "binary/raw" : "binary/compressed";
+
+    Frame frame(natoms);
+    frame.cell(UnitCell(50));
+    auto time = benchmark::run([&](){
+        Trajectory file(FILENAME, "w");
+        file.option("precision", precision);
+        for (size_t step=0; step<NSTEPS; step++) {
+            frame.step(step);
+            frame.positions() = steps[step];
+            file << frame;
+        }
+    });
+    benchmark::report(name + "-write", natoms, time / NSTEPS, benchmark::throughput(megabytes, time, "MB"));
+    auto size = benchmark::file_size(FILENAME);
+    benchmark::report_size(name + "-size", natoms, size, ratio(size, raw_size));
+
+    time = benchmark::run([&](){
+        Trajectory file(FILENAME);
+        for (size_t step=0; step<NSTEPS; step++) {
+            frame = file.read();
+        }
+        benchmark::do_not_optimize(frame);
+    });
+    benchmark::report(name + "-read", natoms, time / NSTEPS, benchmark::throughput(megabytes, time, "MB"));
+}
+
+int main() {
+    for (auto natoms: std::initializer_list<size_t>{1000, 100000}) {
+        auto steps = random_walk(natoms);
+        benchmark_codec(steps, natoms);
+        benchmark_binary(steps, natoms, 0);
+        benchmark_binary(steps, natoms, PRECISION);
+    }
+
+    std::remove(FILENAME);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of all the registered formats, on synthetic systems from 1k to
+// 10M atoms. For each format and size, this measures the latency of opening a
+// file and counting its steps, and the throughput of writing, reading
+// sequentially and reading the steps in a random order.
+//
+// Usage: benchmark-formats [max_atoms [format...]]
+//
+// The results are written to the standard output as tab separated values,
+// and the formats which can not be benchmarked are reported on the standard
+// error.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+#include "chemfiles/TrajectoryFactory.hpp"
+using namespace chemfiles;
+
+static const char* FILENAME = "benchmark-formats.tmp";
+// Number of atoms in all the steps of the smaller files
+static const size_t TOTAL_ATOMS = 10000000;
+// Size of the cubic unit cell, in Angstroms
+static const float CELL_SIZE = 100;
+
+// Get the number of steps to use for a system with \c natoms atoms, keeping
+// the files small for the biggest systems.
+static size_t steps_count(size_t natoms) {
+    return std::max<size_t>(2, std::min<size_t>(20, TOTAL_ATOMS / natoms));
+}
+
+// Create a frame with \c natoms atoms, looking like water molecules
+static Frame synthetic_frame(size_t natoms) {
+    Topology topology;
+    topology.reserve(natoms);
+    for (size_t i=0; i<natoms; i++) {
+        topology.append(Atom(i % 3 == 0 ? "O" : "H"));
+    }
+    Frame frame(topology);
+    frame.cell(UnitCell(CELL_SIZE));
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> positions(0, CELL_SIZE);
+    for (auto& position: frame.positions()) {
+        position = Vector3D(positions(random), positions(random), positions(random));
+    }
+    return frame;
+}
+
+static std::string atoms_throughput(size_t natoms, size_t nsteps, double time) {
+    return benchmark::throughput(static_cast<double>(natoms * nsteps) / 1e6, time, "Matoms");
+}
+
+static void benchmark_format(const std::string& format, Frame& frame) {
+    auto natoms = frame.natoms();
+    auto nsteps = steps_count(natoms);
+    // A single run is enough for the biggest systems
+    size_t repeat = natoms >= 1000000 ? 1 : 5;
+
+    auto time = benchmark::run([&](){
+        Trajectory file(FILENAME, "w", format);
+        for (size_t step=0; step<nsteps; step++) {
+            frame.step(step);
+            file << frame;
+        }
+    }, repeat);
+    benchmark::report(format + "/write", natoms, time / static_cast<double>(nsteps), atoms_throughput(natoms, nsteps, time));
+
+    auto builder = TrajectoryFactory::get().format(format);
+    std::unique_ptr<File> file;
+    std::unique_ptr<Format> reader;
+    time = benchmark::run([&](){
+        reader.reset();
+        file = builder.file_creator(FILENAME, "r");
+        reader = builder.format_creator(*file);
+    }, repeat);
+    benchmark::report(format + "/open", natoms, time);
+
+    size_t count = 0;
+    time = benchmark::run([&](){
+        count = reader->nsteps();
+    }, repeat);
+    benchmark::report(format + "/nsteps", natoms, time);
+    reader.reset();
+    file.reset();
+    if (count != nsteps) {
+        throw Error("Wrong number of steps: expected " + std::to_string(nsteps) + ", got " + std::to_string(count));
+    }
+
+    Frame read;
+    time = benchmark::run([&](){
+        Trajectory trajectory(FILENAME, "r", format);
+        for (size_t step=0; step<nsteps; step++) {
+            read = trajectory.read();
+        }
+        benchmark::do_not_optimize(read);
+    }, repeat);
+    benchmark::report(format + "/read", natoms, time / static_cast<double>(nsteps), atoms_throughput(natoms, nsteps, time));
+
+    std::vector<size_t> steps(nsteps);
+    std::iota(steps.begin(), steps.end(), 0);
+    std::shuffle(steps.begin(), steps.end(), std::mt19937(42));
+    time = benchmark::run([&](){
+        Trajectory trajectory(FILENAME, "r", format);
+        for (auto step: steps) {
+            read = trajectory.read_step(step);
+        }
+        benchmark::do_not_optimize(read);
+    }, repeat);
+    benchmark::report(format + "/read-step", natoms, time / static_cast<double>(nsteps), atoms_throughput(natoms, nsteps, time));
+}
+
+int main(int argc, char** argv) {
+    size_t max_atoms = 10000000;
+    if (argc > 1) {
+        max_atoms = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+    std::vector<std::string> formats(argv + std::min(argc, 2), argv + argc);
+    if (formats.empty()) {
+        formats = TrajectoryFactory::get().names();
+    }
+
+    std::cout << "# chemfiles " << CHEMFILES_VERSION << std::endl;
+    for (size_t natoms=1000; natoms<=max_atoms; natoms*=10) {
+        auto frame = synthetic_frame(natoms);
+        for (auto& format: formats) {
+            try {
+                benchmark_format(format, frame);
+            } catch (const std::exception& e) {
+                std::cerr << "skipping " << format << " with " << natoms << " atoms: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    std::remove(FILENAME);
+    return 0;
+}
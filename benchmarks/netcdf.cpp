@@ -0,0 +1,171 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the per-frame latency of the Amber NetCDF reader, reading the
+// frames one by one or in blocks, and of the writing throughput and file size
+// of the NetCDF 3 and compressed NetCDF 4 files, including when syncing the
+// file while writing.
+
+#include <cstdio>
+#include <initializer_list>
+
+#include "benchmark.hpp"
+#include "chemfiles/config.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+#if HAVE_NETCDF
+
+static const char* FILENAME = "benchmark-netcdf.nc";
+static const size_t NSTEPS = 100;
+static const size_t STRIDE = 10;
+
+// Write a trajectory with \c natoms atoms and NSTEPS steps
+static void write_trajectory(size_t natoms) {
+    Trajectory file(FILENAME, "w");
+    Frame frame(natoms);
+    frame.cell(UnitCell(50, 60, 70));
+    for (size_t step=0; step<NSTEPS; step++) {
+        for (size_t i=0; i<natoms; i++) {
+            frame.positions()[i] = Vector3D(
+                static_cast<float>(i % 50), static_cast<float>(step), static_cast<float>(i % 70)
+            );
+        }
+        file << frame;
+    }
+}
+
+// Benchmark writing NSTEPS steps of a system with \c natoms atoms in the
+// given \c format, with positions looking like a simulation of a liquid.
+static void benchmark_write(const std::string& format, size_t natoms) {
+    Frame frame(natoms);
+    frame.cell(UnitCell(50, 60, 70));
+    // Small pseudo-random displacements around a lattice
+    unsigned state = 12345;
+    auto noise = [&state](){
+        state = state * 1103515245u + 12345u;
+        return static_cast<float>((state >> 16) % 1000) / 1000.0f;
+    };
+
+    auto time = benchmark::run([&](){
+        Trajectory file(FILENAME, "w", format);
+        for (size_t step=0; step<NSTEPS; step++) {
+            for (size_t i=0; i<natoms; i++) {
+                frame.positions()[i] = Vector3D(
+                    static_cast<float>(i % 50) + noise(),
+                    static_cast<float>((i / 50) % 60) + noise(),
+                    static_cast<float>(i / 3000) + noise()
+                );
+            }
+            file << frame;
+        }
+    }, 3);
+
+    auto raw_size = static_cast<double>(NSTEPS * natoms * 3 * sizeof(float));
+    auto name = "netcdf/write-" + format;
+    benchmark::report(name, natoms, time / NSTEPS,
+                      benchmark::throughput(raw_size / (1024 * 1024), time, "MB"));
+    auto size = benchmark::file_size(FILENAME);
+    std::ostringstream ratio;
+    ratio << std::fixed << std::setprecision(2) << size / raw_size;
+    benchmark::report_size(name + "-size", natoms, size, ratio.str() + " of raw size");
+}
+
+// Benchmark writing a lot of small frames, syncing the file every
+// \c sync_every steps.
+static void benchmark_write_sync(size_t nsteps, size_t sync_every) {
+    const size_t natoms = 10;
+    Frame frame(natoms);
+    frame.cell(UnitCell(50, 60, 70));
+    auto time = benchmark::run([&](){
+        Trajectory file(FILENAME, "w");
+        for (size_t step=0; step<nsteps; step++) {
+            frame.positions()[0] = Vector3D(static_cast<float>(step), 0, 0);
+            file << frame;
+            if (step % sync_every == 0) {
+                file.sync();
+            }
+        }
+    }, 3);
+    benchmark::report("netcdf/write-sync-" + std::to_string(sync_every), nsteps, time / static_cast<double>(nsteps),
+                      benchmark::throughput(static_cast<double>(nsteps), time, "frames"));
+}
+
+int main() {
+    benchmark_write_sync(100000, 100);
+    benchmark_write_sync(100000, 1);
+
+    for (auto natoms: std::initializer_list<size_t>{1000, 100000}) {
+        benchmark_write("AmberNetCDF", natoms);
+        benchmark_write("AmberNetCDF4", natoms);
+    }
+
+    for (auto natoms: std::initializer_list<size_t>{10, 1000, 100000}) {
+        write_trajectory(natoms);
+
+        Frame frame;
+        auto time = benchmark::run([&frame](){
+            Trajectory file(FILENAME);
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame = file.read();
+            }
+            benchmark::do_not_optimize(frame);
+        });
+        benchmark::report("netcdf/read-frame", natoms, time / NSTEPS,
+                          benchmark::throughput(static_cast<double>(NSTEPS), time, "frames"));
+
+        time = benchmark::run([&frame](){
+            Trajectory file(FILENAME);
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame = file.read_step((step * 37) % NSTEPS);
+            }
+            benchmark::do_not_optimize(frame);
+        });
+        benchmark::report("netcdf/read-step", natoms, time / NSTEPS,
+                          benchmark::throughput(static_cast<double>(NSTEPS), time, "frames"));
+
+        std::vector<Frame> frames;
+        time = benchmark::run([&frames](){
+            Trajectory file(FILENAME);
+            file.read_block(0, NSTEPS, 1, frames);
+            benchmark::do_not_optimize(frames);
+        });
+        benchmark::report("netcdf/read-block", natoms, time / NSTEPS,
+                          benchmark::throughput(static_cast<double>(NSTEPS), time, "frames"));
+
+        time = benchmark::run([&frame](){
+            Trajectory file(FILENAME);
+            for (size_t step=0; step<NSTEPS; step+=STRIDE) {
+                frame = file.read_step(step);
+            }
+            benchmark::do_not_optimize(frame);
+        });
+        benchmark::report("netcdf/read-step-strided", natoms, time / (NSTEPS / STRIDE),
+                          benchmark::throughput(static_cast<double>(NSTEPS / STRIDE), time, "frames"));
+
+        time = benchmark::run([&frames](){
+            Trajectory file(FILENAME);
+            file.read_block(0, NSTEPS, STRIDE, frames);
+            benchmark::do_not_optimize(frames);
+        });
+        benchmark::report("netcdf/read-block-strided", natoms, time / (NSTEPS / STRIDE),
+                          benchmark::throughput(static_cast<double>(NSTEPS / STRIDE), time, "frames"));
+    }
+
+    std::remove(FILENAME);
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "NetCDF support is disabled, nothing to benchmark." << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,192 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Micro-benchmarks of the in-memory data structures, independently of any
+// file: building topologies and their connectivity, looking up bonds,
+// wrapping vectors in unit cells and guessing the topology from the positions.
+// Each operation is measured for increasing sizes, to give its scaling curve.
+
+#include <cmath>
+#include <initializer_list>
+#include <random>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+// Distance between neighboring water molecules, in Angstroms
+static const float WATER_SPACING = 3.1f;
+
+static std::string per_second(size_t count, double time, const std::string& unit) {
+    return benchmark::throughput(static_cast<double>(count), time, unit);
+}
+
+// Build the topology of \c nmolecules water molecules, without bonds
+static Topology water_topology(size_t nmolecules) {
+    Topology topology;
+    topology.reserve(3 * nmolecules);
+    for (size_t i=0; i<nmolecules; i++) {
+        topology.append(Atom("O"));
+        topology.append(Atom("H"));
+        topology.append(Atom("H"));
+    }
+    return topology;
+}
+
+// Add the bonds of all the water molecules in \c topology
+static void add_water_bonds(Topology& topology) {
+    for (size_t i=0; i<topology.natoms(); i+=3) {
+        topology.add_bond(i, i + 1);
+        topology.add_bond(i, i + 2);
+    }
+}
+
+// Build a linear chain of \c natoms carbon atoms, with all its bonds
+static Topology chain_topology(size_t natoms) {
+    Topology topology;
+    topology.reserve(natoms);
+    for (size_t i=0; i<natoms; i++) {
+        topology.append(Atom("C"));
+        if (i != 0) {
+            topology.add_bond(i - 1, i);
+        }
+    }
+    return topology;
+}
+
+// Build a frame containing \c nmolecules water molecules on a cubic lattice,
+// in a periodic cubic cell.
+static Frame water_box(size_t nmolecules) {
+    auto side = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(nmolecules))));
+    Frame frame(water_topology(nmolecules));
+    frame.cell(UnitCell(static_cast<double>(side) * WATER_SPACING));
+    auto& positions = frame.positions();
+    for (size_t i=0; i<nmolecules; i++) {
+        auto oxygen = WATER_SPACING * Vector3D(
+            static_cast<float>(i % side),
+            static_cast<float>((i / side) % side),
+            static_cast<float>(i / (side * side))
+        );
+        positions[3 * i] = oxygen;
+        positions[3 * i + 1] = oxygen + Vector3D(0.757f, 0.586f, 0);
+        positions[3 * i + 2] = oxygen + Vector3D(-0.757f, 0.586f, 0);
+    }
+    return frame;
+}
+
+static void benchmark_topology(size_t natoms) {
+    auto nmolecules = natoms / 3;
+    auto time = benchmark::run([nmolecules](){
+        auto topology = water_topology(nmolecules);
+        benchmark::do_not_optimize(topology);
+    });
+    benchmark::report("topology/append", natoms, time, per_second(natoms, time, "atoms"));
+
+    auto topology = water_topology(nmolecules);
+    time = benchmark::run([&topology](){
+        auto copy = topology;
+        add_water_bonds(copy);
+        benchmark::do_not_optimize(copy);
+    });
+    benchmark::report("topology/add-bond", natoms, time, per_second(2 * nmolecules, time, "bonds"));
+
+    add_water_bonds(topology);
+    topology.recalculate();
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> atoms(0, natoms - 1);
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (size_t i=0; i<100000; i++) {
+        auto first = atoms(random);
+        auto second = atoms(random);
+        if (first != second) {
+            pairs.emplace_back(first, second);
+        }
+        // Also look for existing bonds
+        pairs.emplace_back(first - first % 3, first - first % 3 + 1);
+    }
+    time = benchmark::run([&topology, &pairs](){
+        size_t count = 0;
+        for (auto& pair: pairs) {
+            if (topology.isbond(pair.first, pair.second)) {
+                count++;
+            }
+        }
+        benchmark::do_not_optimize(count);
+    });
+    benchmark::report("topology/isbond", natoms, time / static_cast<double>(pairs.size()), per_second(pairs.size(), time, "lookups"));
+}
+
+static void benchmark_recalculate(size_t nbonds) {
+    auto water = water_topology(nbonds / 2);
+    add_water_bonds(water);
+    auto time = benchmark::run([&water](){
+        water.recalculate();
+    });
+    benchmark::report("connectivity/recalculate-water", nbonds, time, per_second(nbonds, time, "bonds"));
+
+    auto chain = chain_topology(nbonds + 1);
+    time = benchmark::run([&chain](){
+        chain.recalculate();
+    });
+    benchmark::report("connectivity/recalculate-chain", nbonds, time, per_second(nbonds, time, "bonds"));
+}
+
+static void benchmark_wrap(size_t nvectors) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinates(-100, 100);
+    std::vector<Vector3D> vectors(nvectors);
+    for (auto& vector: vectors) {
+        vector = Vector3D(coordinates(random), coordinates(random), coordinates(random));
+    }
+
+    auto cells = std::vector<std::pair<std::string, UnitCell>>{
+        {"infinite", UnitCell()},
+        {"orthorombic", UnitCell(20, 30, 40)},
+        {"triclinic", UnitCell(20, 30, 40, 80, 95, 110)},
+    };
+    for (auto& cell: cells) {
+        std::vector<Vector3D> wrapped(nvectors);
+        auto time = benchmark::run([&](){
+            for (size_t i=0; i<nvectors; i++) {
+                wrapped[i] = cell.second.wrap(vectors[i]);
+            }
+            benchmark::do_not_optimize(wrapped);
+        });
+        benchmark::report("cell/wrap-" + cell.first, nvectors, time / static_cast<double>(nvectors), per_second(nvectors, time, "vectors"));
+    }
+}
+
+static void benchmark_guess_topology(size_t natoms) {
+    auto frame = water_box(natoms / 3);
+    // Copying the frame is needed to start without bonds each time, and is
+    // included in the measured time. This also recalculates the connectivity.
+    auto time = benchmark::run([&frame](){
+        auto copy = frame;
+        copy.guess_topology(true);
+        benchmark::do_not_optimize(copy);
+    });
+    benchmark::report("frame/guess-topology", natoms, time, per_second(natoms, time, "atoms"));
+}
+
+int main() {
+    // The bonds lookups need to recalculate the connectivity first, which
+    // compares all pairs of bonds.
+    for (auto natoms: std::initializer_list<size_t>{1000, 10000, 100000}) {
+        benchmark_topology(natoms);
+    }
+    for (auto nbonds: std::initializer_list<size_t>{100, 1000, 10000}) {
+        benchmark_recalculate(nbonds);
+    }
+    for (auto nvectors: std::initializer_list<size_t>{1000, 100000, 1000000}) {
+        benchmark_wrap(nvectors);
+    }
+    for (auto natoms: std::initializer_list<size_t>{1000, 3000, 10000}) {
+        benchmark_guess_topology(natoms);
+    }
+    return 0;
+}
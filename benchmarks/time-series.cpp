@@ -0,0 +1,76 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the time series of atoms: reading the positions of a few atoms
+// for all the steps from a trajectory or from a transposed time series file,
+// and the throughput of the transposition itself.
+
+#include <cstdio>
+#include <initializer_list>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+static const char* TRAJECTORY = "benchmark-series.chfl";
+static const char* SERIES = "benchmark-series.chts";
+static const size_t NSTEPS = 200;
+static const size_t NSELECTED = 10;
+
+int main() {
+    for (auto natoms: std::initializer_list<size_t>{1000, 100000}) {
+        {
+            Frame frame(natoms);
+            for (size_t i=0; i<natoms; i++) {
+                frame.positions()[i] = Vector3D(
+                    static_cast<float>(i % 50), static_cast<float>(i % 60), static_cast<float>(i % 70)
+                );
+            }
+            Trajectory file(TRAJECTORY, "w");
+            for (size_t step=0; step<NSTEPS; step++) {
+                frame.step(step);
+                file << frame;
+            }
+        }
+        auto megabytes = static_cast<double>(NSTEPS * natoms * 3 * sizeof(float)) / (1024 * 1024);
+
+        auto time = benchmark::run([](){
+            Trajectory file(TRAJECTORY);
+            TimeSeries::transpose(file, SERIES);
+        });
+        benchmark::report("series/transpose", natoms, time, benchmark::throughput(megabytes, time, "MB"));
+
+        // Time series of NSELECTED atoms, reading all the frames
+        std::vector<Array3D> series(NSELECTED, Array3D(NSTEPS));
+        time = benchmark::run([&series, natoms](){
+            Trajectory file(TRAJECTORY);
+            Frame frame;
+            for (size_t step=0; step<NSTEPS; step++) {
+                file >> frame;
+                for (size_t i=0; i<NSELECTED; i++) {
+                    series[i][step] = frame.positions()[i * natoms / NSELECTED];
+                }
+            }
+            benchmark::do_not_optimize(series);
+        });
+        benchmark::report("series/trajectory-read", natoms, time / NSELECTED);
+
+        time = benchmark::run([&series, natoms](){
+            TimeSeries file(SERIES);
+            for (size_t i=0; i<NSELECTED; i++) {
+                file.positions(i * natoms / NSELECTED, series[i]);
+            }
+            benchmark::do_not_optimize(series);
+        });
+        benchmark::report("series/series-read", natoms, time / NSELECTED);
+    }
+
+    std::remove(TRAJECTORY);
+    std::remove(SERIES);
+    return 0;
+}
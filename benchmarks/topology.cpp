@@ -0,0 +1,64 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the construction of topologies for molecular systems, with a
+// small number of different atoms.
+
+#include <initializer_list>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+static const std::vector<std::string> NAMES = {
+    "C", "CA", "CB", "N", "O", "OW", "HW1", "HW2", "H", "HA", "S", "P",
+};
+
+// Build a topology with \c natoms atoms, creating the atoms from their names
+static Topology build_topology(size_t natoms) {
+    Topology topology;
+    topology.reserve(natoms);
+    for (size_t i=0; i<natoms; i++) {
+        topology.append(Atom(NAMES[i % NAMES.size()]));
+    }
+    return topology;
+}
+
+int main() {
+    std::cout << "sizeof(Atom) = " << sizeof(Atom) << " bytes" << std::endl;
+
+    for (auto natoms: std::initializer_list<size_t>{1000, 100000, 1000000}) {
+        auto time = benchmark::run([natoms](){
+            auto topology = build_topology(natoms);
+            benchmark::do_not_optimize(topology);
+        });
+        benchmark::report("topology/build", natoms, time,
+                          benchmark::throughput(static_cast<double>(natoms), time, "atoms"));
+
+        auto topology = build_topology(natoms);
+        time = benchmark::run([&topology, natoms](){
+            size_t count = 0;
+            for (size_t i=1; i<natoms; i++) {
+                if (topology[i] == topology[i - 1]) {
+                    count++;
+                }
+            }
+            benchmark::do_not_optimize(count);
+        });
+        benchmark::report("topology/compare", natoms, time,
+                          benchmark::throughput(static_cast<double>(natoms), time, "atoms"));
+
+        time = benchmark::run([&topology](){
+            auto copy = topology;
+            benchmark::do_not_optimize(copy);
+        });
+        benchmark::report("topology/copy", natoms, time);
+    }
+
+    return 0;
+}
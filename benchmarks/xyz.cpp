@@ -0,0 +1,56 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Benchmark of the throughput of the XYZ writer, with different precisions
+// for the positions.
+
+#include <cstdio>
+#include <initializer_list>
+
+#include "benchmark.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+static const char* FILENAME = "benchmark-xyz.xyz";
+static const size_t NSTEPS = 10;
+
+int main() {
+    for (auto natoms: std::initializer_list<size_t>{1000, 1000000}) {
+        Topology topology;
+        topology.reserve(natoms);
+        for (size_t i=0; i<natoms; i++) {
+            topology.append(Atom(i % 3 == 0 ? "O" : "H"));
+        }
+        Frame frame;
+        frame.topology(topology);
+        frame.resize(natoms);
+        for (size_t i=0; i<natoms; i++) {
+            frame.positions()[i] = Vector3D(
+                static_cast<float>(i % 50) + 0.123456f,
+                static_cast<float>(i % 60) - 0.654321f,
+                static_cast<float>(i % 70) * 1.5f
+            );
+        }
+
+        for (auto precision: {3, 5}) {
+            auto time = benchmark::run([&frame, precision](){
+                Trajectory file(FILENAME, "w");
+                file.option("precision", precision);
+                for (size_t step=0; step<NSTEPS; step++) {
+                    file << frame;
+                }
+            });
+            auto megabytes = benchmark::file_size(FILENAME) / (1024 * 1024);
+            benchmark::report("xyz/write-" + std::to_string(precision), natoms, time / NSTEPS,
+                              benchmark::throughput(megabytes, time, "MB"));
+        }
+    }
+
+    std::remove(FILENAME);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_FRONTEND_QUEUE_HPP
+#define CHEMFILES_FRONTEND_QUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace chemfiles {
+
+/*!
+* @class Queue Queue.hpp
+* @brief Bounded blocking queue, passing values between two threads.
+*
+* The producer blocks in \c push while the queue is full, and the consumer
+* blocks in \c pop while it is empty. The producer calls \c close after the
+* last value, and any side can call \c abort to stop the other one, for
+* example after an error.
+*/
+template <class T>
+class Queue {
+public:
+    //! Create a queue containing at most \c capacity values
+    explicit Queue(size_t capacity): _capacity(capacity), _closed(false), _aborted(false) {}
+
+    //! Add \c value at the end of the queue, waiting for some space if the
+    //! queue is full. This returns false if the queue was aborted, in which
+    //! case the value is dropped.
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _not_full.wait(lock, [this](){return _aborted || _values.size() < _capacity;});
+        if (_aborted) {
+            return false;
+        }
+        _values.push_back(std::move(value));
+        _not_empty.notify_one();
+        return true;
+    }
+
+    //! Remove the first value in the queue and store it in \c value, waiting
+    //! for a value if the queue is empty. This returns false if the queue was
+    //! aborted, or closed and empty.
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _not_empty.wait(lock, [this](){return _aborted || _closed || !_values.empty();});
+        if (_aborted || _values.empty()) {
+            return false;
+        }
+        value = std::move(_values.front());
+        _values.pop_front();
+        _not_full.notify_one();
+        return true;
+    }
+
+    //! Signal that no more values will be pushed in the queue
+    void close() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _not_empty.notify_all();
+    }
+
+    //! Stop both the producer and the consumer, dropping the remaining values
+    void abort() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _values.clear();
+        _not_empty.notify_all();
+        _not_full.notify_all();
+    }
+private:
+    //! Maximal number of values in the queue
+    size_t _capacity;
+    //! Values in the queue
+    std::deque<T> _values;
+    //! Was the queue closed by the producer?
+    bool _closed;
+    //! Was the queue aborted?
+    bool _aborted;
+    //! Mutex protecting all the other members
+    std::mutex _mutex;
+    //! Condition signaled when a value is added
+    std::condition_variable _not_empty;
+    //! Condition signaled when a value is removed
+    std::condition_variable _not_full;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -0,0 +1,63 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// Binary frontend to chemfiles, giving access to some operations on
+// trajectories from the command line: `chemfiles <command> [options]`.
+
+#include <iostream>
+#include <map>
+
+#include "commands.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+static const char USAGE[] =
+R"(chemfiles: work with trajectory files from the command line
+
+Usage:
+  chemfiles <command> [arguments...]
+  chemfiles --help | --version
+
+Commands:
+  convert    Convert a trajectory from one format to another
+  info       Print a summary of the content of a trajectory
+
+Use `chemfiles <command> --help` for the arguments of a command.
+)";
+
+int main(int argc, char** argv) {
+    auto commands = std::map<std::string, command_t>{
+        {"convert", convert},
+        {"info", info},
+    };
+
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (arguments.empty() || arguments[0] == "-h" || arguments[0] == "--help") {
+        std::cout << USAGE;
+        return arguments.empty() ? 1 : 0;
+    }
+    if (arguments[0] == "--version") {
+        std::cout << "chemfiles " << CHEMFILES_VERSION << std::endl;
+        return 0;
+    }
+
+    auto it = commands.find(arguments[0]);
+    if (it == commands.end()) {
+        std::cerr << "chemfiles: unknown command '" << arguments[0] << "'" << std::endl;
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    try {
+        arguments.erase(arguments.begin());
+        return it->second(arguments);
+    } catch (const std::exception& e) {
+        std::cerr << "chemfiles " << it->first << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,29 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_FRONTEND_COMMANDS_HPP
+#define CHEMFILES_FRONTEND_COMMANDS_HPP
+
+#include <string>
+#include <vector>
+
+namespace chemfiles {
+
+//! Sub-commands of the frontend take the command line arguments following
+//! the command name, and return the exit status of the program. Usage errors
+//! are reported by throwing a \c chemfiles::Error.
+using command_t = int (*)(const std::vector<std::string>& arguments);
+
+//! Convert a trajectory from one format to another
+int convert(const std::vector<std::string>& arguments);
+//! Print a summary of the content of a trajectory
+int info(const std::vector<std::string>& arguments);
+
+} // namespace chemfiles
+
+#endif
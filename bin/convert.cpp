@@ -0,0 +1,283 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// The convert command reads, transforms and writes the frames on separate
+// threads, connected by bounded queues. Parsing the input, wrapping the
+// positions and formatting the output then happen at the same time, and the
+// slowest of the three steps gives the overall throughput. The queues bound
+// the number of frames in memory.
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "chemfiles.hpp"
+#include "commands.hpp"
+#include "options.hpp"
+#include "Queue.hpp"
+using namespace chemfiles;
+
+static const char USAGE[] =
+R"(chemfiles convert: convert a trajectory from one format to another
+
+Usage:
+  chemfiles convert [options] <input> <output>
+
+The formats are guessed from the files extensions, unless they are given
+explicitly. The input can be a glob pattern, matching multiple files read as
+a single trajectory.
+
+Options:
+  --input-format <format>   format to use for the input file
+  --output-format <format>  format to use for the output file
+  --topology <file>         read the topology from this file instead of the
+                            input trajectory
+  --selection <atoms>       only convert these atoms, as a comma separated
+                            list of indexes or ranges: `0,3,5-10`
+  --stride <n>              only convert one step every <n> steps [default: 1]
+  --wrap                    wrap the positions in the unit cell, for frames
+                            with a fully periodic cell
+  --queue <n>               maximal number of frames waiting between two
+                            threads [default: 8]
+  -q, --quiet               do not print the throughput report
+  -h, --help                show this help
+)";
+
+struct convert_options_t {
+    std::string input;
+    std::string output;
+    std::string input_format;
+    std::string output_format;
+    std::string topology;
+    std::vector<size_t> selection;
+    size_t stride = 1;
+    bool wrap = false;
+    size_t queue = 8;
+    bool quiet = false;
+};
+
+// Parse an index in a selection, where 0 is valid
+static size_t parse_index(const std::string& value) {
+    if (value == "0") {
+        return 0;
+    }
+    return parse_positive("--selection", value);
+}
+
+// Parse a list of atoms like `0,3,5-10`, with inclusive ranges
+static std::vector<size_t> parse_selection(const std::string& value) {
+    std::vector<size_t> atoms;
+    size_t start = 0;
+    while (start <= value.size()) {
+        auto end = value.find(',', start);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        auto item = value.substr(start, end - start);
+        auto dash = item.find('-');
+        if (dash == std::string::npos) {
+            atoms.push_back(parse_index(item));
+        } else {
+            auto first = parse_index(item.substr(0, dash));
+            auto last = parse_index(item.substr(dash + 1));
+            if (last < first) {
+                throw Error("invalid range '" + item + "' in --selection");
+            }
+            for (auto i=first; i<=last; i++) {
+                atoms.push_back(i);
+            }
+        }
+        start = end + 1;
+    }
+    return atoms;
+}
+
+static convert_options_t parse_options(const std::vector<std::string>& arguments) {
+    convert_options_t options;
+    std::vector<std::string> positional;
+    for (size_t i=0; i<arguments.size(); i++) {
+        auto& argument = arguments[i];
+        auto value = [&]() -> const std::string& {
+            if (i + 1 >= arguments.size()) {
+                throw Error("missing value for " + argument);
+            }
+            return arguments[++i];
+        };
+
+        if (argument == "-h" || argument == "--help") {
+            options.input.clear();
+            return options;
+        } else if (argument == "--input-format") {
+            options.input_format = value();
+        } else if (argument == "--output-format") {
+            options.output_format = value();
+        } else if (argument == "--topology") {
+            options.topology = value();
+        } else if (argument == "--selection") {
+            options.selection = parse_selection(value());
+        } else if (argument == "--stride") {
+            options.stride = parse_positive(argument, value());
+        } else if (argument == "--wrap") {
+            options.wrap = true;
+        } else if (argument == "--queue") {
+            options.queue = parse_positive(argument, value());
+        } else if (argument == "-q" || argument == "--quiet") {
+            options.quiet = true;
+        } else if (argument.size() > 1 && argument[0] == '-') {
+            throw Error("unknown option " + argument);
+        } else {
+            positional.push_back(argument);
+        }
+    }
+    if (positional.size() != 2) {
+        throw Error("expected an input and an output file, got " + std::to_string(positional.size()) + " files");
+    }
+    options.input = positional[0];
+    options.output = positional[1];
+    return options;
+}
+
+// Get the size in bytes of the file at \c path, or 0 if it can not be opened
+static size_t file_size(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return 0;
+    }
+    auto size = file.tellg();
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+static void wrap_positions(Frame& frame) {
+    auto& cell = frame.cell();
+    if (cell.type() == UnitCell::INFINITE || !cell.full_periodic()) {
+        return;
+    }
+    for (auto& position: frame.positions()) {
+        position = cell.wrap(position);
+    }
+}
+
+// Run \c function, and store the first error in \c error. All the queues are
+// aborted on errors, to stop the other threads.
+template <class Function>
+static void run_stage(Function function, std::exception_ptr& error, std::vector<Queue<Frame>*> queues) {
+    try {
+        function();
+    } catch (...) {
+        error = std::current_exception();
+        for (auto queue: queues) {
+            queue->abort();
+        }
+    }
+}
+
+int chemfiles::convert(const std::vector<std::string>& arguments) {
+    auto options = parse_options(arguments);
+    if (options.input.empty()) {
+        std::cout << USAGE;
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Trajectory input(options.input, "r", options.input_format);
+    input.enable_counters();
+    if (!options.topology.empty()) {
+        input.topology(options.topology);
+    }
+    if (!options.selection.empty()) {
+        input.selection(options.selection);
+    }
+    auto output = std::unique_ptr<Trajectory>(new Trajectory(options.output, "w", options.output_format));
+
+    // The reader sends frames to the transformer, which sends them to the
+    // writer. Without transformations, the reader sends the frames directly
+    // to the writer.
+    Queue<Frame> read_queue(options.queue);
+    Queue<Frame> write_queue(options.queue);
+    auto& reader_output = options.wrap ? read_queue : write_queue;
+    auto all_queues = std::vector<Queue<Frame>*>{&read_queue, &write_queue};
+
+    std::exception_ptr reader_error;
+    std::thread reader([&](){
+        run_stage([&](){
+            auto nsteps = input.nsteps();
+            // Read all the steps sequentially, since going directly to a step
+            // is slow with the text formats.
+            for (size_t step=0; step<nsteps; step++) {
+                auto frame = input.read();
+                if (step % options.stride != 0) {
+                    continue;
+                }
+                if (!reader_output.push(std::move(frame))) {
+                    return;
+                }
+            }
+            reader_output.close();
+        }, reader_error, all_queues);
+    });
+
+    std::exception_ptr transform_error;
+    std::thread transformer;
+    if (options.wrap) {
+        transformer = std::thread([&](){
+            run_stage([&](){
+                Frame frame;
+                while (read_queue.pop(frame)) {
+                    wrap_positions(frame);
+                    if (!write_queue.push(std::move(frame))) {
+                        return;
+                    }
+                }
+                write_queue.close();
+            }, transform_error, all_queues);
+        });
+    }
+
+    size_t nframes = 0;
+    std::exception_ptr writer_error;
+    run_stage([&](){
+        Frame frame;
+        while (write_queue.pop(frame)) {
+            output->write(frame);
+            nframes++;
+        }
+    }, writer_error, all_queues);
+
+    reader.join();
+    if (transformer.joinable()) {
+        transformer.join();
+    }
+    for (auto& error: {reader_error, transform_error, writer_error}) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Close the output file to get its final size
+    output.reset();
+    auto end = std::chrono::steady_clock::now();
+    if (options.quiet) {
+        return 0;
+    }
+
+    auto time = std::chrono::duration<double>(end - start).count();
+    auto input_bytes = input.counters().bytes_read;
+    if (input_bytes == 0) {
+        // Some formats do not count the bytes they read
+        input_bytes = file_size(options.input);
+    }
+    auto output_bytes = file_size(options.output);
+    std::cout << "converted " << nframes << " frames in " << time << " s: "
+              << static_cast<double>(nframes) / time << " frames/s, "
+              << static_cast<double>(input_bytes) / time / 1e6 << " MB/s read, "
+              << static_cast<double>(output_bytes) / time / 1e6 << " MB/s written" << std::endl;
+    return 0;
+}
@@ -0,0 +1,314 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+// The info command splits the steps of a trajectory in contiguous chunks, one
+// per thread. Each thread opens the trajectory on its own, goes directly to the
+// first step of its chunk and then reads the following steps sequentially. The
+// summaries of all the chunks are merged at the end, while the main thread
+// reports the progress. Only formats with an index of the steps are split, the
+// other ones would need to read all the previous steps in each thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "chemfiles.hpp"
+#include "chemfiles/File.hpp"
+#include "chemfiles/Format.hpp"
+#include "chemfiles/TrajectoryFactory.hpp"
+#include "commands.hpp"
+#include "options.hpp"
+using namespace chemfiles;
+
+static const char USAGE[] =
+R"(chemfiles info: print a summary of the content of a trajectory
+
+Usage:
+  chemfiles info [options] <trajectory>
+
+This prints the number of steps and atoms, the range of the unit cell
+parameters and the bounding box of the positions for all the steps. The
+trajectory can be a glob pattern, matching multiple files read as a single
+trajectory.
+
+Options:
+  --format <format>  format to use for the trajectory
+  --threads <n>      number of threads reading the trajectory [default: number
+                     of cores]. Only single files in formats which can go
+                     directly to a step and can be read from multiple threads
+                     use more than one thread.
+  -q, --quiet        do not show the progress
+  -h, --help         show this help
+)";
+
+// Interval between two updates of the progress
+static const auto PROGRESS_INTERVAL = std::chrono::milliseconds(200);
+
+struct info_options_t {
+    std::string path;
+    std::string format;
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool quiet = false;
+};
+
+// Minimal and maximal values of a quantity
+struct range_t {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value) {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const range_t& other) {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+};
+
+// Summary of the steps in a part of the trajectory
+struct summary_t {
+    size_t nsteps = 0;
+    range_t natoms;
+    // Number of steps without unit cell
+    size_t infinite_cells = 0;
+    // Ranges of a, b, c, alpha, beta and gamma for the other steps
+    range_t cell[6];
+    // Ranges of the x, y and z coordinates
+    range_t positions[3];
+
+    void add(const Frame& frame) {
+        nsteps++;
+        natoms.add(static_cast<double>(frame.natoms()));
+        auto& unit_cell = frame.cell();
+        if (unit_cell.type() == UnitCell::INFINITE) {
+            infinite_cells++;
+        } else {
+            auto parameters = {
+                unit_cell.a(), unit_cell.b(), unit_cell.c(),
+                unit_cell.alpha(), unit_cell.beta(), unit_cell.gamma()
+            };
+            size_t i = 0;
+            for (auto value: parameters) {
+                cell[i++].add(value);
+            }
+        }
+        for (auto& position: frame.positions()) {
+            for (size_t i=0; i<3; i++) {
+                positions[i].add(static_cast<double>(position[i]));
+            }
+        }
+    }
+
+    void merge(const summary_t& other) {
+        nsteps += other.nsteps;
+        natoms.merge(other.natoms);
+        infinite_cells += other.infinite_cells;
+        for (size_t i=0; i<6; i++) {
+            cell[i].merge(other.cell[i]);
+        }
+        for (size_t i=0; i<3; i++) {
+            positions[i].merge(other.positions[i]);
+        }
+    }
+};
+
+static info_options_t parse_options(const std::vector<std::string>& arguments) {
+    info_options_t options;
+    std::vector<std::string> positional;
+    for (size_t i=0; i<arguments.size(); i++) {
+        auto& argument = arguments[i];
+        auto value = [&]() -> const std::string& {
+            if (i + 1 >= arguments.size()) {
+                throw Error("missing value for " + argument);
+            }
+            return arguments[++i];
+        };
+
+        if (argument == "-h" || argument == "--help") {
+            options.path.clear();
+            return options;
+        } else if (argument == "--format") {
+            options.format = value();
+        } else if (argument == "--threads") {
+            options.threads = parse_positive(argument, value());
+        } else if (argument == "-q" || argument == "--quiet") {
+            options.quiet = true;
+        } else if (argument.size() > 1 && argument[0] == '-') {
+            throw Error("unknown option " + argument);
+        } else {
+            positional.push_back(argument);
+        }
+    }
+    if (positional.size() != 1) {
+        throw Error("expected a single trajectory, got " + std::to_string(positional.size()) + " files");
+    }
+    options.path = positional[0];
+    return options;
+}
+
+// Can the trajectory be split in chunks read by different threads? This needs
+// a single file, in a format which can be read from multiple threads and which
+// can go directly to the first step of each chunk.
+static bool can_split(const info_options_t& options) {
+    if (!std::ifstream(options.path).good()) {
+        // Glob patterns are read by a single thread
+        return false;
+    }
+    trajectory_builder_t builder;
+    if (options.format.empty()) {
+        builder = TrajectoryFactory::get().guess(options.path, "r");
+    } else {
+        builder = TrajectoryFactory::get().format(options.format);
+    }
+    if (!builder.thread_safe) {
+        return false;
+    }
+    auto file = builder.file_creator(options.path, "r");
+    auto format = builder.format_creator(*file);
+    return format->random_access();
+}
+
+// Read the steps from \c first to \c last in \c trajectory, adding them to
+// \c summary. \c done is incremented after each step.
+static void summarize(Trajectory& trajectory, size_t first, size_t last, summary_t& summary, std::atomic<size_t>& done) {
+    Frame frame;
+    for (size_t step=first; step<last; step++) {
+        if (step == first && first != 0) {
+            frame = trajectory.read_step(step);
+        } else {
+            trajectory >> frame;
+        }
+        summary.add(frame);
+        done++;
+    }
+}
+
+static std::string format_range(const range_t& range) {
+    std::ostringstream output;
+    if (range.min == range.max) {
+        output << range.min;
+    } else {
+        output << range.min << " to " << range.max;
+    }
+    return output.str();
+}
+
+static void print_range(const std::string& name, const range_t& range) {
+    std::cout << "  " << name << ": " << format_range(range) << std::endl;
+}
+
+int chemfiles::info(const std::vector<std::string>& arguments) {
+    auto options = parse_options(arguments);
+    if (options.path.empty()) {
+        std::cout << USAGE;
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    // The first chunk is read with this trajectory, the other threads open
+    // their own.
+    Trajectory trajectory(options.path, "r", options.format);
+    auto nsteps = trajectory.nsteps();
+    size_t nthreads = 1;
+    if (options.threads > 1 && nsteps > 1 && can_split(options)) {
+        nthreads = std::min(options.threads, nsteps);
+    }
+    std::vector<summary_t> summaries(nthreads);
+    std::atomic<size_t> done(0);
+    size_t finished = 0;
+    std::mutex mutex;
+    std::condition_variable all_finished;
+    std::exception_ptr error;
+
+    std::vector<std::thread> threads;
+    for (size_t i=0; i<nthreads; i++) {
+        auto first = i * nsteps / nthreads;
+        auto last = (i + 1) * nsteps / nthreads;
+        threads.emplace_back([&, i, first, last](){
+            try {
+                if (i == 0) {
+                    summarize(trajectory, first, last, summaries[i], done);
+                } else {
+                    Trajectory chunk(options.path, "r", options.format);
+                    summarize(chunk, first, last, summaries[i], done);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            finished++;
+            all_finished.notify_one();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto is_finished = [&](){return finished == nthreads;};
+        while (!all_finished.wait_for(lock, PROGRESS_INTERVAL, is_finished)) {
+            if (!options.quiet) {
+                std::cerr << "\rread " << done << "/" << nsteps << " steps" << std::flush;
+            }
+        }
+    }
+    if (!options.quiet) {
+        std::cerr << "\rread " << done << "/" << nsteps << " steps" << std::endl;
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    summary_t summary;
+    for (auto& chunk: summaries) {
+        summary.merge(chunk);
+    }
+    auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "steps: " << summary.nsteps << std::endl;
+    if (summary.nsteps == 0) {
+        return 0;
+    }
+    std::cout << "atoms: " << format_range(summary.natoms) << std::endl;
+    if (summary.infinite_cells != summary.nsteps) {
+        std::cout << "cell:" << std::endl;
+        auto names = {"a", "b", "c", "alpha", "beta", "gamma"};
+        size_t i = 0;
+        for (auto name: names) {
+            print_range(name, summary.cell[i++]);
+        }
+    }
+    if (summary.infinite_cells != 0) {
+        std::cout << "steps without cell: " << summary.infinite_cells << std::endl;
+    }
+    if (summary.natoms.max != 0) {
+        std::cout << "bounding box:" << std::endl;
+        print_range("x", summary.positions[0]);
+        print_range("y", summary.positions[1]);
+        print_range("z", summary.positions[2]);
+    }
+    if (!options.quiet) {
+        std::cerr << "read " << summary.nsteps << " steps in " << time << " s with "
+                  << nthreads << " threads: " << static_cast<double>(summary.nsteps) / time << " steps/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#include "options.hpp"
+#include "chemfiles/Error.hpp"
+using namespace chemfiles;
+
+size_t chemfiles::parse_positive(const std::string& option, const std::string& value) {
+    size_t end = 0;
+    unsigned long long result = 0;
+    try {
+        result = std::stoull(value, &end);
+    } catch (const std::exception&) {
+        end = 0;
+    }
+    if (end == 0 || end != value.size() || result == 0 || value[0] == '-') {
+        throw Error("invalid value '" + value + "' for " + option + ", expected a positive integer");
+    }
+    return static_cast<size_t>(result);
+}
@@ -0,0 +1,22 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_FRONTEND_OPTIONS_HPP
+#define CHEMFILES_FRONTEND_OPTIONS_HPP
+
+#include <string>
+
+namespace chemfiles {
+
+//! Parse a strictly positive integer from the \c value of the command line
+//! \c option, throwing an Error if it is not valid.
+size_t parse_positive(const std::string& option, const std::string& value);
+
+} // namespace chemfiles
+
+#endif
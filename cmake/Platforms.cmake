@@ -7,3 +7,6 @@ if(${UNIX})
     set(OTHER_CHEMFILES_LIBRARIES ${LIBDL_LIBRARY})
 endif()
 mark_as_advanced(LIBDL_LIBRARY)
+
+find_package(Threads REQUIRED)
+set(OTHER_CHEMFILES_LIBRARIES ${OTHER_CHEMFILES_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
@@ -22,6 +22,7 @@
 
 #ifdef __cplusplus
     #include <cstddef>
+    #include <cstdint>
 extern "C" {
 
     namespace chemfiles {
@@ -38,6 +39,7 @@ extern "C" {
     typedef chemfiles::Topology CHFL_TOPOLOGY;
 #else
     #include <stddef.h>
+    #include <stdint.h>
     #include <stdbool.h>
     //! Opaque type handling trajectories files
     typedef struct CHFL_TRAJECTORY CHFL_TRAJECTORY;
@@ -60,6 +62,10 @@ CHFL_EXPORT const char* chfl_strerror(int status);
 
 /*!
 * @brief Get the last error message.
+*
+* The error messages are stored separately for each thread, and this function
+* returns the last error which happened in the calling thread. The string is
+* valid until the next error in the same thread.
 * @return A null-terminated string encoding the textual representation of the last error.
 */
 CHFL_EXPORT const char* chfl_last_error();
@@ -185,6 +191,40 @@ CHFL_EXPORT int chfl_trajectory_set_cell(CHFL_TRAJECTORY *file, const CHFL_CELL
 */
 CHFL_EXPORT int chfl_trajectory_nsteps(CHFL_TRAJECTORY *file, size_t *nsteps);
 
+//! Instrumentation counters of a trajectory
+typedef struct CHFL_COUNTERS {
+    //! Number of bytes read from the files
+    uint64_t bytes_read;
+    //! Number of frames read
+    uint64_t frames_read;
+    //! Number of frames written
+    uint64_t frames_written;
+    //! Time spent reading data from the files, in seconds
+    double file_time;
+    //! Time spent in the formats, excluding the time spent in the files, in seconds
+    double format_time;
+    //! Time spent setting the custom topology and unit cell and selecting
+    //! atoms after reading the frames, in seconds
+    double post_processing_time;
+} chfl_counters_t;
+
+/*!
+* @brief Start counting the data read and written and the time spent in a
+* trajectory, resetting all the counters to zero.
+* @param file A pointer to the trajectory
+* @return The status code.
+*/
+CHFL_EXPORT int chfl_trajectory_enable_counters(CHFL_TRAJECTORY *file);
+
+/*!
+* @brief Get the instrumentation counters of a trajectory. All the counters
+* are zero if they were not enabled with chfl_trajectory_enable_counters.
+* @param file A pointer to the trajectory
+* @param counters This will contain the counters values
+* @return The status code.
+*/
+CHFL_EXPORT int chfl_trajectory_counters(const CHFL_TRAJECTORY *file, chfl_counters_t *counters);
+
 /*!
 * @brief Synchronize any buffered content to the hard drive.
 * @param file A pointer to the file
@@ -234,6 +274,21 @@ CHFL_EXPORT int chfl_frame_positions(const CHFL_FRAME* frame, float (*data)[3],
 */
 CHFL_EXPORT int chfl_frame_set_positions(CHFL_FRAME* frame, float const (*data)[3], size_t size);
 
+/*!
+* @brief Get a pointer to the positions of a frame, without copying them.
+*
+* The positions are stored contiguously as a Nx3 float array in row-major
+* order, and can be modified through the pointer. The pointer is owned by the
+* frame, and is only valid until the next call to a function changing the
+* number of atoms in the frame, such as chfl_frame_set_positions,
+* chfl_trajectory_read or chfl_trajectory_read_step.
+* @param frame The frame
+* @param data A pointer to be set to the positions, or NULL if the frame is empty
+* @param size The number of atoms in the frame (N)
+* @return The status code
+*/
+CHFL_EXPORT int chfl_frame_positions_data(CHFL_FRAME* frame, float (**data)[3], size_t* size);
+
 /*!
 * @brief Get the velocities from a frame, if they exists
 * @param frame The frame
@@ -252,6 +307,18 @@ CHFL_EXPORT int chfl_frame_velocities(const CHFL_FRAME* frame, float (*data)[3],
 */
 CHFL_EXPORT int chfl_frame_set_velocities(CHFL_FRAME* frame, float const (*data)[3], size_t size);
 
+/*!
+* @brief Get a pointer to the velocities of a frame, without copying them.
+*
+* This function works like chfl_frame_positions_data. If the frame does not
+* have velocities, \c data is set to NULL and \c size to 0.
+* @param frame The frame
+* @param data A pointer to be set to the velocities, or NULL
+* @param size The number of velocities in the frame (N)
+* @return The status code
+*/
+CHFL_EXPORT int chfl_frame_velocities_data(CHFL_FRAME* frame, float (**data)[3], size_t* size);
+
 /*!
 * @brief Check if a frame has velocity information.
 * @param frame The frame
@@ -442,7 +509,7 @@ CHFL_EXPORT CHFL_TOPOLOGY* chfl_topology();
 * @param frame The frame
 * @return A pointer to the new Topology
 */
-CHFL_EXPORT CHFL_TOPOLOGY* chfl_topology_from_frame(CHFL_FRAME* frame);
+CHFL_EXPORT CHFL_TOPOLOGY* chfl_topology_from_frame(const CHFL_FRAME* frame);
 
 /*!
 * @brief Get the current number of atoms in the topology.
@@ -549,6 +616,28 @@ CHFL_EXPORT int chfl_topology_angles(const CHFL_TOPOLOGY* topology, size_t (*dat
 */
 CHFL_EXPORT int chfl_topology_dihedrals(const CHFL_TOPOLOGY* topology, size_t (*data)[4], size_t ndihedrals);
 
+/*!
+* @brief Get the lists of bonds, angles and dihedral angles in the system in
+* a single call. Any of the \c bonds, \c angles or \c dihedrals arrays can be
+* NULL, and the corresponding data is then not copied.
+* @param topology The topology
+* @param bonds A nbonds x 2 array to be filled with the bonds in the system
+* @param nbonds The size of the \c bonds array. This should equal the value
+*               given by the chfl_topology_bonds_count function
+* @param angles A nangles x 3 array to be filled with the angles in the system
+* @param nangles The size of the \c angles array. This should equal the value
+*               given by the chfl_topology_angles_count function
+* @param dihedrals A ndihedrals x 4 array to be filled with the dihedral angles
+*                  in the system
+* @param ndihedrals The size of the \c dihedrals array. This should equal the
+*                   value given by the chfl_topology_dihedrals_count function
+* @return The status code
+*/
+CHFL_EXPORT int chfl_topology_connectivity(const CHFL_TOPOLOGY* topology,
+                                           size_t (*bonds)[2], size_t nbonds,
+                                           size_t (*angles)[3], size_t nangles,
+                                           size_t (*dihedrals)[4], size_t ndihedrals);
+
 /*!
 * @brief Add a bond between the atoms \c i and \c j in the system
 * @param topology The topology
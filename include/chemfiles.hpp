@@ -29,6 +29,8 @@
 #include "chemfiles/Frame.hpp"
 #include "chemfiles/UnitCell.hpp"
 #include "chemfiles/Trajectory.hpp"
+#include "chemfiles/TimeSeries.hpp"
+#include "chemfiles/NeighborList.hpp"
 
 #undef CHEMFILES_PUBLIC
 
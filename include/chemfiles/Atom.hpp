@@ -10,6 +10,7 @@
 #define CHEMFILES_ATOM_HPP
 
 #include <string>
+#include <functional>
 
 #include "chemfiles/exports.hpp"
 
@@ -20,6 +21,12 @@ namespace chemfiles {
  *
  * An Atom is a particle in the current Frame. It can be used to store and retrieve
  * informations about a particle, such as mass, name, atomic number, etc.
+ *
+ * Atom names are interned in a global table: all the atoms with the same name
+ * share the same string, and comparing or hashing names only uses the address
+ * of this string. The table only grows: interned names are never released, so
+ * creating atoms with many different names keeps all of them in memory until
+ * the end of the program.
  */
 class CHFL_EXPORT Atom {
 public:
@@ -49,7 +56,7 @@ public:
     ~Atom() = default;
 
     //! Get a const (non-modifiable) reference to the atom name
-    const std::string& name() const {return _name;}
+    const std::string& name() const {return *_name;}
     //! Get a const (non-modifiable) reference to the atom mass
     const float& mass() const {return _mass;}
     //! Get a const (non-modifiable) reference to the atom charge
@@ -58,7 +65,7 @@ public:
     const AtomType& type() const {return _type;}
 
     //! Set the atom name
-    void name(const std::string& n) {_name = n;}
+    void name(const std::string& n);
     //! Set the atom mass
     void mass(float m) {_mass = m;}
     //! Set the atom charge
@@ -75,17 +82,35 @@ public:
     //! Try to get the atomic number, if defined. Returns -1 if it can not be found.
     int atomic_number() const;
 private:
-    std::string _name;
+    //! Interned name of the atom
+    const std::string* _name;
+    //! Atomic number of the element with the same name as this atom, used to
+    //! index the periodic table. This is -1 if the name is not an element name.
+    int _element;
     float _mass;
     float _charge;
     AtomType _type;
 };
 
 inline bool operator==(const Atom& lhs, const Atom& rhs) {
-    return (lhs.name() == rhs.name() && lhs.mass() == rhs.mass() &&
+    // Names are interned, so comparing the addresses is enough
+    return (&lhs.name() == &rhs.name() && lhs.mass() == rhs.mass() &&
             lhs.charge() == rhs.charge() && lhs.type() == rhs.type());
 }
 
 } // namespace chemfiles
 
+namespace std {
+    //! Hashing function for using atoms as keys in unordered containers
+    template<> struct hash<chemfiles::Atom> {
+        size_t operator()(const chemfiles::Atom& atom) const {
+            size_t seed = hash<const string*>()(&atom.name());
+            seed ^= hash<float>()(atom.mass()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hash<float>()(atom.charge()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hash<int>()(atom.type()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+} // namespace std
+
 #endif
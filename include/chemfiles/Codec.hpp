@@ -0,0 +1,58 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_CODEC_HPP
+#define CHEMFILES_CODEC_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "chemfiles/Vector3D.hpp"
+
+namespace chemfiles {
+
+/*!
+ * @class LossyCodec Codec.hpp Codec.cpp
+ * @brief Lossy compression of arrays of 3D vectors, such as positions.
+ *
+ * The values are quantized to a fixed precision, and the quantized values
+ * are delta-encoded against the previous array given to the codec. Keyframes
+ * do not depend on the previous array, but use the difference between
+ * consecutive values of the same array. The residuals are then zigzag
+ * encoded and bit-packed in blocks sharing the same number of bits.
+ *
+ * All the decoded values are within half of the precision of the initial
+ * values. An encoder and a decoder must see the same sequence of arrays,
+ * starting with a keyframe.
+ */
+class LossyCodec {
+public:
+    //! Create a codec storing values with the given \c precision
+    explicit LossyCodec(double precision);
+
+    //! Get the precision of this codec
+    double precision() const {return _precision;}
+
+    //! Encode \c array and append the result to \c output. If \c keyframe is
+    //! false, the array must have the same size as the previous one.
+    void encode(const Array3D& array, bool keyframe, std::vector<char>& output);
+    //! Decode \c size bytes from \c data in \c array. The \c keyframe value
+    //! must be the same as when encoding.
+    void decode(const char* data, size_t size, bool keyframe, Array3D& array);
+private:
+    //! Precision of the values
+    double _precision;
+    //! Quantized values of the previous array
+    std::vector<int32_t> _previous;
+    //! Buffer for the residuals
+    std::vector<uint32_t> _residuals;
+};
+
+} // namespace chemfiles
+
+#endif
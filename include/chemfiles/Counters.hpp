@@ -0,0 +1,74 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+* Copyright (C) 2015 Guillaume Fraux
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_COUNTERS_HPP
+#define CHEMFILES_COUNTERS_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace chemfiles {
+
+/*!
+* @class Counters Counters.hpp
+* @brief Instrumentation counters of a Trajectory.
+*
+* The counters are disabled by default, and can be enabled with
+* \c Trajectory::enable_counters. The time spent in the files and in the
+* formats do not overlap, so that their sum is the total time spent reading
+* and writing.
+*/
+struct Counters {
+    //! Number of bytes read from the files
+    uint64_t bytes_read = 0;
+    //! Number of frames read
+    uint64_t frames_read = 0;
+    //! Number of frames written
+    uint64_t frames_written = 0;
+    //! Time spent reading data from the files, in seconds
+    double file_time = 0;
+    //! Time spent in the formats decoding and encoding frames, excluding the
+    //! time spent in the files, in seconds
+    double format_time = 0;
+    //! Time spent after reading the frames, setting the custom topology and
+    //! unit cell and selecting atoms, in seconds
+    double post_processing_time = 0;
+};
+
+/*!
+* @class CounterTimer Counters.hpp
+* @brief Add the time spent during the lifetime of this object to one of the
+* time counters, if the counters are enabled.
+*/
+class CounterTimer {
+public:
+    //! Add the time to the \c time member of \c counters, which can be null
+    CounterTimer(Counters* counters, double Counters::* time): _counters(counters), _time(time) {
+        if (_counters) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~CounterTimer() {
+        if (_counters) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start;
+            _counters->*_time += elapsed.count();
+        }
+    }
+
+    CounterTimer(const CounterTimer&) = delete;
+    CounterTimer& operator=(const CounterTimer&) = delete;
+private:
+    Counters* _counters;
+    double Counters::* _time;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -10,6 +10,7 @@
 #define CHEMFILES_FILES_HPP
 
 #include "chemfiles/Error.hpp"
+#include "chemfiles/Counters.hpp"
 
 #include <string>
 #include <vector>
@@ -37,11 +38,24 @@ public:
     const std::string& filename() const {return _filename;}
     //! File opening mode.
     const std::string& mode() const {return _mode;}
+
+    //! Can different files of this class be used from different threads at
+    //! the same time? Classes using a library with global state should set
+    //! this to false.
+    static constexpr bool thread_safe = true;
+
+    //! Get the counters to update when reading this file, or nullptr if the
+    //! counters are disabled.
+    Counters* counters() const {return _counters;}
+    //! Set the counters to update when reading this file. Use nullptr to
+    //! disable the counters.
+    void counters(Counters* counters) {_counters = counters;}
 protected:
-    File(const std::string& path, const std::string& mode) : _filename(path), _mode(mode) {}
+    File(const std::string& path, const std::string& mode) : _filename(path), _mode(mode), _counters(nullptr) {}
 private:
     const std::string _filename;
     const std::string _mode;
+    Counters* _counters;
 };
 
 /*!
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 using std::shared_ptr;
 
 #include "chemfiles/File.hpp"
@@ -48,6 +49,47 @@ public:
     */
     virtual void read(Frame& frame);
 
+    /*!
+    * @brief Read the steps from \c first to \c last (excluded) with a given
+    *        \c stride from the associated file.
+    * @param first The first step to read
+    * @param last The step after the last one to read
+    * @param stride The number of steps between two consecutive frames
+    * @param frames The frames to fill. This vector is resized to the number of
+    *               steps to read, and the frames already in it are reused.
+    *
+    * The default implementation calls \c read_step for the first step, and
+    * then \c read for all the following steps, skipping the steps between
+    * two frames. This function can throw an exception in case of error.
+    */
+    virtual void read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames);
+
+    //! Can this format go directly to any step in \c read_step, in a time
+    //! independent of the step? Formats without an index of the steps need
+    //! to read all the previous steps instead. The default implementation
+    //! returns false.
+    virtual bool random_access() const;
+
+    /*!
+    * @brief Only read the atoms with indexes in \c atoms in the next frames.
+    * @param atoms The sorted indexes of the atoms to read, or an empty vector
+    *              to read all the atoms.
+    * @return Whether this format can read only the selected atoms. If it can
+    *         not, all the atoms are read and the frames are filtered afterward.
+    *
+    * The default implementation does not support selections.
+    */
+    virtual bool selection(const std::vector<size_t>& atoms);
+
+    /*!
+    * @brief Set the format-specific option \c name to \c value.
+    * @param name The name of the option
+    * @param value The new value of the option
+    *
+    * The default implementation throws a FormatError, as there is no option.
+    */
+    virtual void option(const std::string& name, double value);
+
     /*!
     * @brief Write a step (frame) to the associated file.
     * @param frame The frame to be writen
@@ -67,6 +109,13 @@ public:
 
     //! File class to use with this Format. This is for registration in the Factory.
     using file_t = BasicFile;
+
+    //! Check if \c header, containing the first bytes of a file, looks like
+    //! this format. This is used by the Factory to find the format of files
+    //! without a known extension, and should be fast. Formats can hide this
+    //! function to recognize their files, the default does not recognize any
+    //! file.
+    static bool sniff(const std::string&) {return false;}
 protected:
     //! File associated with this Format instance.
     File& file;
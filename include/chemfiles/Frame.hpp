@@ -9,6 +9,8 @@
 #ifndef CHEMFILES_FRAME_HPP
 #define CHEMFILES_FRAME_HPP
 
+#include <memory>
+
 #include "chemfiles/Vector3D.hpp"
 #include "chemfiles/Topology.hpp"
 #include "chemfiles/UnitCell.hpp"
@@ -22,6 +24,12 @@ namespace chemfiles {
  *
  * The Frame class holds data from one step of a simulation: the current topology,
  * the positions, and maybe the velocities of the particles in the system.
+ *
+ * The topology is reference-counted, and shared between all the frames read
+ * from a trajectory with a constant topology. It is only copied when modified
+ * through a frame sharing it with others. Topologies created by a frame, which
+ * can be modified through references given by \c topology(), are copied with
+ * the frame so that these references never affect the copies.
  */
 class CHFL_EXPORT Frame {
 public:
@@ -33,6 +41,11 @@ public:
     //! specific topology.
     explicit Frame(Topology top, bool has_velocities = false);
 
+    Frame(const Frame& other);
+    Frame& operator=(const Frame& other);
+    Frame(Frame&&) = default;
+    Frame& operator=(Frame&&) = default;
+
     //! Get a modifiable reference to the positions
     Array3D& positions() {return _positions;}
     //! Get a const (non modifiable) reference to the positions
@@ -62,12 +75,20 @@ public:
     //! Get the number of particles in the system
     size_t natoms() const;
 
-    //! Get a modifiable reference to the internal topology
-    Topology& topology() {return _topology;}
+    //! Get a modifiable reference to the internal topology. If the topology
+    //! is shared with other frames, this makes a copy of it first.
+    Topology& topology();
     //! Get a const (non-modifiable) reference to the internal topology
-    const Topology& topology() const {return _topology;}
-    //! Set the system topology
-    void topology(const Topology& top) {_topology = top;}
+    const Topology& topology() const {return *_topology;}
+    //! Set the system topology, by copying \c top
+    void topology(const Topology& top);
+    //! Share the topology \c top with this frame. \c top must not be modified
+    //! afterward, as it will be seen by all the frames sharing it. Modifying
+    //! the topology through this frame always works on a copy of \c top.
+    void topology(std::shared_ptr<const Topology> top);
+    //! Get a shared pointer to the internal topology, which can be used to
+    //! share it with other frames.
+    std::shared_ptr<const Topology> shared_topology() const {return _topology;}
 
     //! Get a const (non-modifiable) reference to the unit cell of the system
     const UnitCell& cell() const {return _cell;}
@@ -100,8 +121,11 @@ private:
     Array3D _positions;
     //! Velocities of the particles
     Array3D _velocities;
-    //! Topology of the described system
-    Topology _topology;
+    //! Topology of the described system, shared with other frames
+    std::shared_ptr<const Topology> _topology;
+    //! Modifiable pointer to the same topology if it was created by a frame,
+    //! or \c nullptr if it was given as a const topology by the caller.
+    Topology* _modifiable;
     //! Unit cell of the system
     UnitCell _cell;
 };
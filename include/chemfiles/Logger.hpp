@@ -13,16 +13,21 @@
 #ifndef CHEMFILES_LOGGING_H
 #define CHEMFILES_LOGGING_H
 
+#include <atomic>
 #include <string>
 #include <ostream>
 
-#include "chemfiles/exports.hpp"
+#include "chemfiles/config.hpp"
 
 namespace chemfiles {
 
 /*!
  * @class Logger Logger.hpp Logger.cpp
  * @brief The Logger class is a singleton class providing logging facilities.
+ *
+ * The messages are formatted in a buffer local to the calling thread, and
+ * written to the log stream at once when they are complete. This makes the
+ * logger safe to use from multiple threads.
  */
 class CHFL_EXPORT Logger {
 public:
@@ -40,12 +45,48 @@ public:
         DEBUG = 4
     };
 
+    /*!
+     * @class Message Logger.hpp Logger.cpp
+     * @brief A single log message, written to the log stream when destroyed.
+     */
+    class CHFL_EXPORT Message {
+    public:
+        //! Start a new message with the given \c level
+        explicit Message(LogLevel level);
+        //! Write the message to the log stream
+        ~Message();
+        //! Get the stream to write the message content
+        std::ostream& stream() {return _stream;}
+    private:
+        Message(const Message&) = delete;
+        Message& operator=(const Message&) = delete;
+        //! Stream local to the current thread
+        std::ostream& _stream;
+    };
+
+    /*!
+     * @class Voidify Logger.hpp
+     * @brief Helper for the LOG macro, turning a message stream into a void
+     *        expression.
+     *
+     * The \c & operator has a lower precedence than \c <<, so that the full
+     * message is written to the stream before reaching this operator.
+     */
+    class Voidify {
+    public:
+        void operator&(std::ostream&) {}
+    };
+
     ~Logger();
 
     //! Set the logging level
     static void level(LogLevel);
     //! Get the current logging level
-    static LogLevel level() {return instance.current_level;}
+    static LogLevel level() {return instance.current_level.load(std::memory_order_relaxed);}
+    //! Check if the messages with the given \c level will be logged
+    static bool enabled(LogLevel level) {
+        return level != NONE && level <= Logger::level();
+    }
     //! Set the file for logging
     static void log_to_file(const std::string &filename);
     //! Make the logger output to stdout
@@ -55,14 +96,11 @@ public:
     //! Make the logger output to stdlog
     static void log_to_stdlog();
 
-    //! Get the singleton out stream
-    static std::ostream& out(LogLevel level);
-
 private:
     //! Close the log file if it exists.
     void close();
-    //! Return a stream to write the log
-    std::ostream& get_stream(LogLevel level);
+    //! Write a complete \c message to the log stream
+    void write(const std::string& message);
     //! Constructor
     Logger();
 
@@ -77,7 +115,7 @@ private:
     static Logger instance;
 
     //! Logging level
-    LogLevel current_level;
+    std::atomic<LogLevel> current_level;
     //! Current log stream
     std::ostream* os; // A raw pointer is needed to hold reference to the standard streams
     //! Is the current stream a file ?
@@ -87,8 +125,17 @@ private:
 } // namespace chemfiles
 
 #ifndef CHEMFILES_PUBLIC
-    //! The LOG macro should be used to get a stream with the good logging level
-    #define LOG(level) chemfiles::Logger::out(chemfiles::Logger::level)
+    #ifndef CHEMFILES_LOG_MIN_LEVEL
+        #define CHEMFILES_LOG_MIN_LEVEL DEBUG
+    #endif
+    //! The LOG macro should be used to get a stream with the good logging
+    //! level. If the level is disabled, the message is not evaluated at all.
+    //! The macro expands to a single expression, so that it can be used as
+    //! the body of an \c if without braces.
+    #define LOG(level)                                                         \
+        (chemfiles::Logger::level > chemfiles::Logger::CHEMFILES_LOG_MIN_LEVEL || \
+         !chemfiles::Logger::enabled(chemfiles::Logger::level)) ? (void)0 :    \
+        chemfiles::Logger::Voidify() & chemfiles::Logger::Message(chemfiles::Logger::level).stream()
 #endif // CHEMFILES_PUBLIC
 
 #endif
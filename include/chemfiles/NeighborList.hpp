@@ -0,0 +1,129 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_NEIGHBOR_LIST_HPP
+#define CHEMFILES_NEIGHBOR_LIST_HPP
+
+#include <vector>
+
+#include "chemfiles/Vector3D.hpp"
+#include "chemfiles/UnitCell.hpp"
+#include "chemfiles/exports.hpp"
+
+namespace chemfiles {
+
+class Frame;
+
+//! A pair of atoms closer than a cutoff distance, with i < j
+struct CHFL_EXPORT neighbor_pair {
+    //! Index of the first atom in the frame
+    size_t i;
+    //! Index of the second atom in the frame
+    size_t j;
+    //! Distance between the atoms, using the minimal image convention
+    double distance;
+};
+
+/*!
+ * @class NeighborList NeighborList.hpp NeighborList.cpp
+ * @brief Find all the pairs of atoms closer than a cutoff distance in a Frame
+ *
+ * The pairs are searched using a cell list built in the fractional coordinates
+ * of the frame unit cell, and cached in a Verlet list containing all the pairs
+ * closer than \c cutoff + \c skin. Calling \c update with a new frame only
+ * recomputes the distances of the cached pairs, as long as no atom moved by
+ * more than half the skin since the last full rebuild.
+ *
+ * Triclinic cells and partial periodicity are supported. In all the periodic
+ * directions, the cutoff plus the skin must be smaller than half the width of
+ * the cell. The search is spread over multiple threads for big systems.
+ */
+class CHFL_EXPORT NeighborList {
+public:
+    //! Create a neighbor list for the given \c cutoff, using a Verlet \c skin
+    //! for incremental updates.
+    explicit NeighborList(double cutoff, double skin = 0);
+
+    //! Build the list from scratch, using all the atoms in \c frame
+    void compute(const Frame& frame);
+    //! Build the list from scratch, only using the pairs of atoms with both
+    //! indexes in \c selection.
+    void compute(const Frame& frame, const std::vector<size_t>& selection);
+    //! Update the list with the positions in \c frame. The list is only rebuilt
+    //! if the unit cell or the number of atoms changed, or if any atom moved by
+    //! more than half the skin since the last rebuild.
+    void update(const Frame& frame);
+
+    //! Get the pairs of atoms closer than the cutoff
+    const std::vector<neighbor_pair>& pairs() const {return _pairs;}
+
+    //! Get the cutoff distance
+    double cutoff() const {return _cutoff;}
+    //! Get the Verlet skin
+    double skin() const {return _skin;}
+    //! Get the number of full rebuilds since the creation of this list
+    size_t rebuilds() const {return _rebuilds;}
+    //! Check if the cutoff plus the skin is smaller than half the width of
+    //! \c cell in all its periodic directions, i.e. if this list can be
+    //! used with frames in this cell.
+    bool fits(const UnitCell& cell) const;
+
+    //! Get the number of threads used to compute the list
+    size_t threads() const {return _threads;}
+    //! Set the number of threads to use. The default value of 0 uses as many
+    //! threads as there are cores on the machine.
+    void threads(size_t n);
+private:
+    //! Build the cell list, and the Verlet list from it, using the atoms in
+    //! \c selection or all the atoms if \c selection is empty. The list is
+    //! not modified if this throws.
+    void rebuild(const Frame& frame, std::vector<size_t> selection);
+    //! Compute the fractional coordinates of the selected atoms in \c frame
+    void fractional(const Array3D& positions);
+    //! Recompute the distances in the Verlet list, and filter them with the cutoff
+    void filter();
+    //! Get the number of atoms used in the list
+    size_t size() const;
+    //! Get the index in the frame of the \c i-th atom used in the list
+    size_t index(size_t i) const {
+        return _selection.empty() ? i : _selection[i];
+    }
+
+    //! Cutoff distance
+    double _cutoff;
+    //! Additional distance for the Verlet list
+    double _skin;
+    //! Number of threads to use
+    size_t _threads;
+    //! Number of full rebuilds
+    size_t _rebuilds;
+    //! Are we using only a subset of the atoms?
+    std::vector<size_t> _selection;
+    //! Number of atoms in the frame used for the last rebuild
+    size_t _natoms;
+    //! Unit cell used for the last rebuild
+    UnitCell _cell;
+    //! Cell matrix, with the cell vectors as columns
+    double _matrix[3][3];
+    //! Inverse of the cell matrix
+    double _inverse[3][3];
+    //! Periodicity of the three cell directions
+    bool _periodic[3];
+    //! Positions of the atoms at the last rebuild
+    Array3D _reference;
+    //! Fractional coordinates of the selected atoms
+    std::vector<std::array<double, 3>> _fractional;
+    //! Verlet list of all the pairs closer than cutoff + skin
+    std::vector<neighbor_pair> _candidates;
+    //! Pairs closer than the cutoff
+    std::vector<neighbor_pair> _pairs;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -0,0 +1,89 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+* Copyright (C) 2015 Guillaume Fraux
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_TIME_SERIES_HPP
+#define CHEMFILES_TIME_SERIES_HPP
+
+#include <memory>
+#include <string>
+
+#include "chemfiles/Vector3D.hpp"
+#include "chemfiles/exports.hpp"
+
+namespace chemfiles {
+
+class RawFile;
+class Trajectory;
+
+/*!
+* @class TimeSeries TimeSeries.hpp TimeSeries.cpp
+* @brief Atom-major storage of the positions in a trajectory.
+*
+* Trajectories store all the atoms of one step together, which makes reading
+* the positions of one atom at all the steps very slow. A TimeSeries file
+* stores instead all the steps of one atom together, so that the time series
+* of an atom can be read at once. These files are created from an existing
+* trajectory with \c TimeSeries::transpose.
+*/
+class CHFL_EXPORT TimeSeries {
+public:
+    /*!
+     * Write the positions of all the steps in \c trajectory to a new time
+     * series file at \c path.
+     *
+     * The trajectory is read by tiles of \c tile steps, using
+     * \c Trajectory::read_block and the selection of the trajectory if there
+     * is one. All the steps must contain the same number of atoms.
+     *
+     * The tile size is a trade-off between memory and writing speed: the
+     * memory used is proportional to \c tile times the number of atoms, and
+     * each atom is written with a separate write of \c tile positions,
+     * unless all the steps fit in a single tile. Small tiles make a lot of
+     * small writes.
+     */
+    static void transpose(Trajectory& trajectory, const std::string& path, size_t tile);
+
+    /*!
+     * Write the positions of all the steps in \c trajectory to a new time
+     * series file at \c path, choosing the tile size from the number of
+     * atoms so that the frames of a tile use about 128 MiB of memory.
+     *
+     * The writes for each atom are then about 128 MiB divided by the number
+     * of atoms, i.e. hundreds of kilobytes for thousands of atoms, but only
+     * a few kilobytes for a hundred thousand atoms.
+     */
+    static void transpose(Trajectory& trajectory, const std::string& path);
+
+    //! Open the time series file at \c path for reading
+    explicit TimeSeries(const std::string& path);
+    TimeSeries(TimeSeries&&);
+    TimeSeries& operator=(TimeSeries&&);
+    ~TimeSeries();
+
+    //! Get the number of atoms in this file
+    size_t natoms() const {return _natoms;}
+    //! Get the number of steps in this file
+    size_t nsteps() const {return _nsteps;}
+
+    //! Get the positions of the atom at index \c atom for all the steps
+    Array3D positions(size_t atom);
+    //! Get the positions of the atom at index \c atom for all the steps in
+    //! \c positions, which is resized to the number of steps.
+    void positions(size_t atom, Array3D& positions);
+private:
+    //! Underlying file
+    std::unique_ptr<RawFile> _file;
+    //! Number of atoms
+    size_t _natoms;
+    //! Number of steps
+    size_t _nsteps;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -12,6 +12,8 @@
 #include <cassert>
 #include <array>
 #include <vector>
+#include <iterator>
+#include <unordered_map>
 #include <unordered_set>
 #include <functional>
 
@@ -92,22 +94,30 @@ private:
 } // namespace chemfiles
 
 namespace std {
-    // We need a hashing function for the std::unordered_set, but it will not
-    // be used. We will use the operator== instead to ensure the element
-    // unicity in the sets.
+    // Hashing functions for storing the bonds, angles and dihedrals in
+    // std::unordered_set. The indexes are combined as in boost::hash_combine.
     template<> struct hash<chemfiles::bond> {
-        size_t operator()(chemfiles::bond const&) const {
-            return 42;
+        size_t operator()(chemfiles::bond const& bond) const {
+            size_t seed = hash<size_t>()(bond[0]);
+            seed ^= hash<size_t>()(bond[1]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
         }
     };
     template<> struct hash<chemfiles::angle> {
-        size_t operator()(chemfiles::angle const&) const {
-            return 42;
+        size_t operator()(chemfiles::angle const& angle) const {
+            size_t seed = hash<size_t>()(angle[0]);
+            seed ^= hash<size_t>()(angle[1]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hash<size_t>()(angle[2]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
         }
     };
     template<> struct hash<chemfiles::dihedral> {
-        size_t operator()(chemfiles::dihedral const&) const {
-            return 42;
+        size_t operator()(chemfiles::dihedral const& dihedral) const {
+            size_t seed = hash<size_t>()(dihedral[0]);
+            seed ^= hash<size_t>()(dihedral[1]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hash<size_t>()(dihedral[2]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= hash<size_t>()(dihedral[3]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
         }
     };
 } // namespace std
@@ -124,7 +134,7 @@ namespace chemfiles {
  */
 class CHFL_EXPORT Connectivity {
 public:
-    Connectivity() = default;
+    Connectivity() : uptodate(false) {}
     //! Recalculate the angles and the dihedrals from the bond list
     void recalculate() const;
     //! Clear all the content
@@ -171,6 +181,14 @@ public:
 
     //! Add an atom in the system
     void append(const Atom& _atom);
+    //! Add all the atoms in the [\c first, \c last) range to the system
+    template <class Iterator>
+    void append(Iterator first, Iterator last) {
+        reserve(_atoms.size() + static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            append(*first);
+        }
+    }
     //! Delete an atom in the system. If \c idx is out of bounds, do nothing.
     void remove(size_t idx);
     //! Add a bond in the system, between the atoms at index \c atom_i and \c atom_j
@@ -188,6 +206,9 @@ public:
     size_t natom_types() const {return _templates.size();}
     //! Reserve space for \c natoms in the topology
     void resize(size_t natoms) {_atoms.resize(natoms);}
+    //! Reserve memory for \c natoms in the topology, without changing the
+    //! current number of atoms.
+    void reserve(size_t natoms) {_atoms.reserve(natoms);}
     //! Clear the topology
     void clear();
 
@@ -206,13 +227,40 @@ public:
     //! Get the dihedral angles in the system
     std::vector<dihedral> dihedrals() const;
 
+    //! Get the number of bonds in the system
+    size_t nbonds() const {return _connect.bonds().size();}
+    //! Get the number of angles in the system
+    size_t nangles() const {return _connect.angles().size();}
+    //! Get the number of dihedral angles in the system
+    size_t ndihedrals() const {return _connect.dihedrals().size();}
+
+    //! Get a *copy* of the bonds, as a C-style array. The array is assumed
+    //! to have a shape (size x 2); i.e. data[size][2]. The \c size should be
+    //! equal to the number of bonds in the system.
+    void raw_bonds(size_t data[][2], size_t size) const;
+    //! Get a *copy* of the angles, as a C-style array. The array is assumed
+    //! to have a shape (size x 3); i.e. data[size][3]. The \c size should be
+    //! equal to the number of angles in the system.
+    void raw_angles(size_t data[][3], size_t size) const;
+    //! Get a *copy* of the dihedral angles, as a C-style array. The array is
+    //! assumed to have a shape (size x 4); i.e. data[size][4]. The \c size
+    //! should be equal to the number of dihedral angles in the system.
+    void raw_dihedrals(size_t data[][4], size_t size) const;
+
     //! Recalculate the angles and dihedrals list from the bond list.
     void recalculate() {_connect.recalculate();}
 private:
+    //! Get the index of \c atom in the templates list, adding it if needed
+    size_t template_index(const Atom& atom);
+
     //! Internal list of particle templates. If the same particle can be found
     //! more than one in a topology, the Atom class will have only one instance,
     //! pointing to this vector.
     std::vector<Atom> _templates;
+    //! Index of the templates, associating each template to its position
+    //! in \c _templates. The templates can be modified through operator[],
+    //! so entries in this index are checked before being used.
+    std::unordered_map<Atom, size_t> _templates_index;
     //! Internal list of atoms. The index refers to the _templates list
     std::vector<size_t> _atoms;
     //! Connectivity of the system. All the indices refers to the atoms in \c _atoms
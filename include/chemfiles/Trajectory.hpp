@@ -11,8 +11,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "chemfiles/Frame.hpp"
+#include "chemfiles/Counters.hpp"
 #include "chemfiles/exports.hpp"
 
 namespace chemfiles {
@@ -47,6 +49,22 @@ public:
      */
     //!
     Trajectory(const std::string& filename, const std::string& mode = "r", const std::string& format = "");
+    /*!
+     * Open multiple files for reading as a single trajectory, with the steps
+     * of all the files numbered one after the other.
+     *
+     * The files are only opened when reading from them, and at most
+     * \c "max_open_files" files (an option with a default value of 16, which
+     * can be changed with \c Trajectory::option) are open at the same time.
+     * Opening a file in \c "r" mode with a glob pattern as \c filename (for
+     * example \c "run.part*.xtc") also reads all the matching files, sorted
+     * by name.
+     *
+     * @param filenames The paths of the files, in reading order.
+     * @param format Specific format to use for all the files. By default, the
+     *               format of each file is guessed from its extension.
+     */
+    Trajectory(const std::vector<std::string>& filenames, const std::string& format = "");
     Trajectory(Trajectory&&);
     Trajectory& operator=(Trajectory&&);
     ~Trajectory();
@@ -55,8 +73,16 @@ public:
     Trajectory& operator>>(Frame& frame);
     //! Read operator, in *method* version
     Frame read();
-    //! Read operator, in *method* version with specific step
+    //! Read operator, in *method* version with specific step. The next call
+    //! to \c read will read the following step.
     Frame read_step(const size_t);
+    //! Read the steps from \c first to \c last (excluded) with a given
+    //! \c stride in \c frames. The vector is resized to the number of steps
+    //! read, and the frames already in it are reused. Some formats can read all
+    //! these steps at once, which is faster than reading them one by one.
+    void read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames);
+    //! Read the steps from \c first to \c last (excluded) with a given \c stride
+    std::vector<Frame> read_block(size_t first, size_t last, size_t stride = 1);
 
     //! Synchronize any content in the underlying buffer to the disk
     void sync();
@@ -77,27 +103,79 @@ public:
     //! information about unit cell is present.
     void cell(const UnitCell&);
 
+    //! Only read the atoms with indexes in \c atoms in the next frames. The
+    //! frames will only contain these atoms, sorted by increasing index, and
+    //! the bonds between them. Some formats can read only the selected atoms
+    //! from the file, which is faster than reading all of them. An empty
+    //! vector disable the selection. The selection is not used when writing.
+    void selection(std::vector<size_t> atoms);
+    //! Get the indexes in the file of the atoms in the frames read from this
+    //! trajectory, i.e. the sorted selection. This is empty if all the atoms
+    //! are read.
+    const std::vector<size_t>& selection() const {return _selection;}
+
+    //! Set the format-specific option \c name to \c value, for example the
+    //! compression precision of some binary formats. This throws a
+    //! FormatError if the format does not know about this option.
+    void option(const std::string& name, double value);
+
+    //! Start counting the bytes and frames read and written, and the time
+    //! spent in the files, in the formats and in post-processing for this
+    //! trajectory. All the counters are reset to zero. Counting has a small
+    //! cost, and is disabled by default.
+    void enable_counters();
+    //! Get the current values of the counters. All the values are zero if the
+    //! counters are not enabled.
+    Counters counters() const;
+    //! Write the current values of the counters to the log, at the INFO level
+    void log_counters() const;
+
     //! Get the number of steps (the number of Frames) in this trajectory
     size_t nsteps() const {return _nsteps;}
     //! Have we read all the Frames in this file ?
     bool done() const;
 private:
+    //! Open the files in \c paths as a single trajectory, using \c name in
+    //! the error messages.
+    void open_files(const std::string& name, std::vector<std::string> paths, const std::string& format);
+    //! Set the custom topology and unit cell in a frame that was just read,
+    //! and only keep the selected atoms in it.
+    void post_read(Frame& frame);
+    //! Only keep the selected atoms in \c frame. If \c positions is false,
+    //! the positions and velocities already only contain the selected atoms.
+    void select_atoms(Frame& frame, bool positions);
+    //! Call \c function, which uses the format, updating the counters
+    template <class Function> void with_format(Function function);
+
     //! Current step
     size_t _step;
     //! Number of steps in the file, if available
     size_t _nsteps;
+    //! The file we are reading from. It is declared before the format, so
+    //! that formats can still write to the file in their destructor.
+    std::unique_ptr<File> _file;
     //! Format used to read the file
     std::unique_ptr<Format> _format;
-    //! The file we are reading from
-    std::unique_ptr<File> _file;
-    //! Topology to use for reading/writing files when no topological data is present
-    Topology _topology;
+    //! Topology to use for reading/writing files when no topological data is
+    //! present. It is shared with all the frames read from this trajectory.
+    std::shared_ptr<const Topology> _topology;
     //! Do we have to use a specific topology ?
     bool _use_custom_topology;
     //! UnitCell to use for reading/writing files when no unit cell information is present
     UnitCell _cell;
     //! Do we have to use a specific unit cell ?
     bool _use_custom_cell;
+    //! Sorted indexes of the atoms to read, or empty to read all the atoms
+    std::vector<size_t> _selection;
+    //! Does the format reads only the selected atoms by itself ?
+    bool _format_selection;
+    //! Last topology filtered with the selection, and the corresponding
+    //! selected topology. This prevents filtering the same topology shared by
+    //! multiple frames again and again.
+    std::shared_ptr<const Topology> _last_topology;
+    std::shared_ptr<const Topology> _last_selected_topology;
+    //! Instrumentation counters, or nullptr if they are disabled
+    std::unique_ptr<Counters> _counters;
 };
 
 } // namespace chemfiles
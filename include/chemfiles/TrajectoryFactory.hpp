@@ -11,6 +11,8 @@
 
 #include <unordered_map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "chemfiles/Format.hpp"
 #include "chemfiles/Error.hpp"
@@ -25,6 +27,8 @@ using std::string;
 typedef unique_ptr<Format> (*format_creator_t) (File& f);
 //! Function type to create a file
 typedef unique_ptr<File> (*file_creator_t) (const string& path, const string& mode);
+//! Function type to check if the start of a file looks like a format
+typedef bool (*sniffer_t) (const string& header);
 
 /*!
 * @class trajectory_builder TrajectoryFactory.hpp
@@ -33,6 +37,11 @@ typedef unique_ptr<File> (*file_creator_t) (const string& path, const string& mo
 struct trajectory_builder_t {
     format_creator_t format_creator;
     file_creator_t file_creator;
+    //! Can different files be read with this format from multiple threads?
+    bool thread_safe;
+    //! Check if the first bytes of a file look like this format, or nullptr
+    //! if the format can not recognize its files.
+    sniffer_t sniff;
 };
 
 //! Files extensions to trajectory builder associations
@@ -53,6 +62,8 @@ private:
     trajectory_map_t formats;
     //! Trajectory map associating format descriptions and readers
     trajectory_map_t extensions;
+    //! Formats which can recognize their files, in registration order
+    std::vector<std::pair<string, trajectory_builder_t>> sniffers;
 
     TrajectoryFactory();
 public:
@@ -79,7 +90,37 @@ public:
      */
     trajectory_builder_t by_extension(const string& ext);
 
-    //! Register a trajectory_builder in the internal format names list.
+    /*!
+     * @brief Get a trajectory_builder from the content of the file at \c path.
+     * @param path the path to an existing file
+     * @return A trajectory_builder corresponding to the first registered
+     *         format recognizing the first bytes of the file.
+     *
+     * Only the first \c SNIFF_SIZE bytes of the file are read, once. Throws
+     * an error if the file can not be read, or if no format recognizes it.
+     */
+    trajectory_builder_t by_content(const string& path);
+
+    /*!
+     * @brief Guess the trajectory_builder to use for the file at \c path.
+     * @param path the path to the file
+     * @param mode the opening mode of the file
+     * @return The trajectory_builder associated with the extension of the
+     *         file if it is registered, or else the one recognizing its
+     *         content when reading or appending.
+     *
+     * Throws an error if the format can not be found
+     */
+    trajectory_builder_t guess(const string& path, const string& mode);
+
+    //! Number of bytes at the start of a file read by \c by_content
+    static constexpr size_t SNIFF_SIZE = 4096;
+
+    //! Get the names of all the registered formats, sorted alphabetically
+    std::vector<string> names() const;
+
+    //! Register a trajectory_builder in the internal format names list. If
+    //! it can recognize its files, it is also used by \c by_content.
     void register_format(const string& name, trajectory_builder_t tb);
     //! Register an trajectory_builder in the internal extensions list.
     void register_extension(const string& ext, trajectory_builder_t tb);
@@ -33,8 +33,12 @@ public:
     ~Vector3D() = default;
 
     using std::array<float, 3>::operator[];
+    using std::array<float, 3>::data;
 };
 
+static_assert(sizeof(Vector3D) == 3 * sizeof(float),
+              "Arrays of Vector3D must have the same layout as arrays of float[3]");
+
 inline bool operator==(const Vector3D& u, const Vector3D& v){
     return u[0] == v[0] && u[1] == v[1] && u[2] == v[2];
 }
@@ -10,7 +10,6 @@
 #define CHEMFILES_CAPI_ERRORS_H
 
 #include <string>
-#include "chemfiles/Logger.hpp"
 
 namespace chemfiles {
 
@@ -33,55 +32,24 @@ struct CAPIStatus {
         LAST,
     };
 
-    CAPIStatus() {
-        messages[SUCESS] = "Operation was sucessfull";
-        messages[STD_ERROR] = "Error in C++ runtime. Use chfl_last_error for more informations.";
-        messages[CHEMHARP] = "Error in chemfiles library. Use chfl_last_error for more informations.";
-        messages[MEMORY] = "Memory error.";
-        messages[FILE] = "Error while reading a file.";
-        messages[FORMAT] = "Error while reading a format.";
-    }
-
     /// Retrive the message corresponding to an error code.
-    const char* message(int i) const {
-        if (i >= 0 && i < LAST)
-            return messages[i];
-        else
-            return "";
-    }
-    std::string last_error;
-private:
-    const char* messages[LAST];
+    static const char* message(int i);
+    /// Get the last error message for the calling thread
+    static const std::string& last_error();
+    /// Set the last error message for the calling thread
+    static void set_last_error(const std::string& message);
+    /// Get the status code corresponding to the exception being currently
+    /// handled, and set the last error message. This must only be called from
+    /// a \c catch block.
+    static int handle_exception();
 };
 
-static CAPIStatus status = CAPIStatus();
-
-#define CATCH_AND_RETURN(exception, retval)           \
-    catch(const chemfiles::exception& e) {            \
-        status.last_error = string(e.what());         \
-        LOG(ERROR) << e.what() << std::endl;          \
-        return retval;                                \
-    }
-
-#define CATCH_AND_GOTO(exception)                     \
-    catch(const chemfiles::exception& e) {            \
-        status.last_error = string(e.what());         \
-        LOG(ERROR) << e.what() << std::endl;          \
-        goto error;                                   \
-    }
-
 //! Wrap \c instructions in a try/catch bloc automatically, and return a status code
 #define CHFL_ERROR_WRAP_RETCODE(instructions)                                  \
     try {                                                                      \
         instructions                                                           \
-    }                                                                          \
-    CATCH_AND_RETURN(FileError, CAPIStatus::FILE)                              \
-    CATCH_AND_RETURN(MemoryError, CAPIStatus::MEMORY)                          \
-    CATCH_AND_RETURN(FormatError, CAPIStatus::FORMAT)                          \
-    CATCH_AND_RETURN(Error, CAPIStatus::CHEMHARP)                              \
-    catch(const std::exception& e) {                                           \
-        status.last_error = string(e.what());                                  \
-        return CAPIStatus::STD_ERROR;                                          \
+    } catch(...) {                                                             \
+        return CAPIStatus::handle_exception();                                 \
     }                                                                          \
     return CAPIStatus::SUCESS;
 
@@ -90,13 +58,8 @@ static CAPIStatus status = CAPIStatus();
 #define CHFL_ERROR_WRAP(instructions)                                          \
     try {                                                                      \
         instructions                                                           \
-    }                                                                          \
-    CATCH_AND_GOTO(FileError)                                                  \
-    CATCH_AND_GOTO(MemoryError)                                                \
-    CATCH_AND_GOTO(FormatError)                                                \
-    CATCH_AND_GOTO(Error)                                                      \
-    catch(const std::exception& e) {                                           \
-        status.last_error = string(e.what());                                  \
+    } catch(...) {                                                             \
+        CAPIStatus::handle_exception();                                        \
         goto error;                                                            \
     }
 
@@ -0,0 +1,35 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_CONFIG_HPP
+#define CHEMFILES_CONFIG_HPP
+
+#define CHEMFILES_VERSION_MAJOR 0
+#define CHEMFILES_VERSION_MINOR 4
+#define CHEMFILES_VERSION_PATCH 0
+#define CHEMFILES_VERSION_SHORT "0.4.0"
+#define CHEMFILES_VERSION "0.4.0-dev"
+
+// Include the export definitions
+#include "chemfiles/exports.hpp"
+
+// Are we compiling for Windows ?
+#if defined( WIN32 ) || defined( _WIN32 ) || defined( __WIN32__ ) || defined( __CYGWIN__ ) || \
+    defined( WIN64 ) || defined( _WIN64 ) || defined( __WIN64__ )
+    #define CHFL_WINDOWS
+#endif
+
+// The CHEMFILES_PUBLIC macro should be defined when including this file to prevent
+// unwanted macros from being exported.
+#ifndef CHEMFILES_PUBLIC
+    #define HAVE_NETCDF 0
+    // Messages less important than this level are removed at compile time
+    #define CHEMFILES_LOG_MIN_LEVEL DEBUG
+#endif // CHEMFILES_PUBLIC
+
+#endif
@@ -28,6 +28,8 @@
 // unwanted macros from being exported.
 #ifndef CHEMFILES_PUBLIC
     #define HAVE_NETCDF @HAVE_NETCDF@
+    // Messages less important than this level are removed at compile time
+    #define CHEMFILES_LOG_MIN_LEVEL @CHEMFILES_LOG_MIN_LEVEL@
 #endif // CHEMFILES_PUBLIC
 
 #endif
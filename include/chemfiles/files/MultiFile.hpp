@@ -0,0 +1,55 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_MULTI_FILE_HPP
+#define CHEMFILES_MULTI_FILE_HPP
+
+#include <string>
+#include <vector>
+
+#include "chemfiles/File.hpp"
+
+namespace chemfiles {
+
+/*!
+ * @class MultiFile files/MultiFile.hpp
+ * @brief List of files read one after the other as a single trajectory.
+ *
+ * This class only stores the paths of the files and the format to use for
+ * them. The files themselves are opened by MultiFormat when needed.
+ */
+class MultiFile : public File {
+public:
+    /*!
+     * Create a list of files for reading.
+     *
+     * @param name The name of this list of files, used in error messages.
+     * @param paths The paths of the files, in reading order.
+     * @param format The format of all the files, or an empty string to guess
+     *               the format of each file from its extension.
+     */
+    MultiFile(const std::string& name, std::vector<std::string> paths, const std::string& format)
+    : File(name, "r"), _paths(std::move(paths)), _format(format) {}
+
+    //! Get the paths of the files
+    const std::vector<std::string>& paths() const {return _paths;}
+    //! Get the format of the files, or an empty string
+    const std::string& format() const {return _format;}
+
+    virtual bool is_open() override {return true;}
+    virtual void sync() override {}
+private:
+    //! Paths of the files
+    std::vector<std::string> _paths;
+    //! Format of the files
+    std::string _format;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -34,12 +34,19 @@ class NCFile : public BinaryFile {
 public:
     explicit NCFile(const string& filename, const string& mode);
 
+    //! The NetCDF library is not thread safe
+    static constexpr bool thread_safe = false;
+
     //! Get a global attribut from the file
     string global_attribute(const string& name) const;
     //! Get the value of a specific dimmension
     size_t dimension(const string& name) const;
     //! Get a valid pointer to a NetCDF variable
     netCDF::NcVar variable(const string& name) const;
+    //! Check if a variable named \c name exists in the file
+    bool has_variable(const string& name) const;
+    //! Check if a dimension named \c name exists in the file
+    bool has_dimension(const string& name) const;
     //! Get an attribute of type \c T and name \c name from the variable of name \c var
     template <typename T>
     T attribute(const string& var, const string& name) const;
@@ -55,12 +62,42 @@ public:
     //! Add an attribute of type \c T and name \c name to the variable with name \c var
     template <typename T>
     void add_attribute(const string& var, const string& name, T value);
+    //! Store the variable with name \c var in chunks of size \c chunks,
+    //! compressed with the shuffle and deflate filters. This does nothing for
+    //! files not using the NetCDF 4 format.
+    void compress_variable(const string& var, const std::vector<size_t>& chunks);
+
+    //! Leave the define mode and write the header of the file. All the
+    //! dimensions, variables and attributes should be created before calling
+    //! this function, as adding new ones afterward rewrites the header.
+    void end_definitions();
+
+    //! Is this file using the HDF5 based NetCDF 4 format ?
+    bool netcdf4() const {return _netcdf4;}
 
     virtual bool is_open() override;
     virtual void sync() override;
+protected:
+    //! Open the file, using the NetCDF 4 format when creating new files if
+    //! \c netcdf4 is true, and the NetCDF 3 64-bit offset format otherwise.
+    NCFile(const string& filename, const string& mode, bool netcdf4);
 private:
     // Underlying NetCDF file
     netCDF::NcFile file;
+    // Are we writing NetCDF 4 files ?
+    bool _netcdf4;
+};
+
+/*!
+ * @class NC4File NCFile.hpp NCFile.cpp
+ * @brief Wrapper around NetCDF 4 binary files
+ *
+ * The same interface as NCFile, creating HDF5 based NetCDF 4 files instead of
+ * NetCDF 3 files. Existing files can use either format.
+ */
+class NC4File : public NCFile {
+public:
+    explicit NC4File(const string& filename, const string& mode) : NCFile(filename, mode, true) {}
 };
 
 //! Get the NetCDF type associated to a c++ type
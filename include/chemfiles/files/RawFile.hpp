@@ -0,0 +1,74 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_RAW_FILE_HPP
+#define CHEMFILES_RAW_FILE_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#include "chemfiles/File.hpp"
+
+namespace chemfiles {
+
+/*!
+ * @class RawFile RawFile.hpp RawFile.cpp
+ * @brief Binary file with random access to its bytes.
+ *
+ * Files opened in read mode are memory-mapped when the platform supports it,
+ * so that reading does not need any copy or system call. The other modes use
+ * the C standard library buffered IO.
+ */
+class RawFile : public BinaryFile {
+public:
+    /*!
+     * Open a binary file.
+     *
+     * @param filename The file path. In \c "w" or \c "a" modes, the file is
+     *                 created if it does not exist yet. In "r" mode, an
+     *                 exception is throwed is the file does not exist yet.
+     * @param mode Opening mode for the file. Supported modes are "r" for read,
+     *             "w" for write and "a" for append. In "a" mode, the existing
+     *             data can be read and overwritten.
+     */
+    explicit RawFile(const std::string& filename, const std::string& mode);
+    ~RawFile();
+
+    //! Get the size of the file in bytes
+    uint64_t size() const {return _size;}
+    //! Get a pointer to the \c count bytes at \c offset in the file. The
+    //! pointer is valid until the next call to a function of this class.
+    const char* read(uint64_t offset, size_t count);
+    //! Write the \c count bytes in \c data at \c offset in the file
+    void write(uint64_t offset, const void* data, size_t count);
+
+    virtual bool is_open() override;
+    virtual void sync() override;
+private:
+    //! Move the file cursor to \c offset before reading or \c writing, if it
+    //! is not already there
+    void seek(uint64_t offset, bool writing);
+
+    //! Underlying C file
+    std::FILE* _file;
+    //! Memory-mapped content of the file in read mode, or nullptr
+    char* _map;
+    //! Current size of the file
+    uint64_t _size;
+    //! Current position of the cursor in the file
+    uint64_t _position;
+    //! Was the last operation a write?
+    bool _writing;
+    //! Buffer used for reading when the file is not memory-mapped
+    std::vector<char> _buffer;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -0,0 +1,139 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_FORMAT_BINARY_HPP
+#define CHEMFILES_FORMAT_BINARY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chemfiles/Vector3D.hpp"
+#include "chemfiles/Format.hpp"
+#include "chemfiles/register_formats.hpp"
+
+namespace chemfiles {
+
+class LossyCodec;
+class RawFile;
+class Topology;
+
+/*!
+ * @class BinaryFormat formats/Binary.hpp formats/Binary.cpp
+ * @brief Native binary format of chemfiles.
+ *
+ * This format is made to be fast to write and to read in any order. All the
+ * values are stored in little-endian order. A file contains:
+ *
+ * - an header of 64 bytes, with the number of atoms, the size of the topology
+ *   and the position of the frames index;
+ * - the topology, stored only once;
+ * - the frames, all of the same size: step, unit cell, positions and
+ *   optionally velocities as 32-bit floats;
+ * - an index with the position of each frame, written when closing the file.
+ *
+ * If a file was not closed properly, the frames are found by walking the file.
+ *
+ * Setting the \c "precision" option before writing the first frame creates a
+ * compressed file, where the positions and velocities are stored with the
+ * LossyCodec at this precision. Compressed frames have different sizes, and
+ * only keyframes can be decoded without the previous frames.
+ */
+class BinaryFormat : public Format {
+public:
+    BinaryFormat(File& file);
+    ~BinaryFormat();
+
+    virtual void read_step(const size_t step, Frame& frame) override;
+    virtual void read(Frame& frame) override;
+    virtual bool random_access() const override;
+    virtual void write(const Frame& frame) override;
+    virtual void option(const std::string& name, double value) override;
+
+    virtual size_t nsteps() const override;
+    virtual std::string description() const override;
+
+    //! Recognize files starting with the magic number of this format
+    static bool sniff(const std::string& header);
+
+    using file_t = RawFile;
+
+    // Register the binary format with the ".chfl" extension and the
+    // "ChemfilesBinary" description.
+    FORMAT_NAME(ChemfilesBinary)
+    FORMAT_EXTENSION(.chfl)
+private:
+    //! Read the header, the topology and the frames index of an existing file
+    void read_header();
+    //! Rebuild the frames index by walking the frames in the file
+    void recover();
+    //! Write the header and the topology of a new file, using \c frame for the
+    //! number of atoms, the velocities and the topology.
+    void initialize(const Frame& frame);
+    //! Write the header of the file, with a frames index at \c index_offset,
+    //! or without index if \c index_offset is 0.
+    void write_header(uint64_t index_offset);
+    //! Write the positions or velocities in \c array at \c offset
+    void write_array(uint64_t offset, const Array3D& array);
+    //! Compress the positions and velocities of \c frame in the buffer
+    void write_compressed(const Frame& frame, bool keyframe);
+    //! Get a pointer to the frame at \c step, and its \c size in bytes
+    const char* read_record(size_t step, uint64_t& size);
+    //! Decode the compressed frame in \c data, with the given \c size
+    void decode_record(const char* data, uint64_t size, Array3D& positions, Array3D& velocities);
+    //! Decode all the frames needed before decoding the frame at \c step
+    void decode_until(size_t step);
+    //! Write the frames index and the final header to the file
+    void finalize();
+    //! Size in bytes of a frame in this file
+    uint64_t frame_size() const;
+
+    //! Reference to the associated file.
+    RawFile& rawfile;
+    //! Current step for sequential reading
+    size_t step;
+    //! Number of atoms in the file
+    size_t natoms;
+    //! Does the file contains velocities?
+    bool velocities;
+    //! Was the header of the file written or read?
+    bool initialized;
+    //! Was the header marked as missing the index since we started writing?
+    bool writing;
+    //! Position of the first frame in the file
+    uint64_t data_offset;
+    //! Position of each frame in the file
+    std::vector<uint64_t> offsets;
+    //! Topology read from the file, shared with all the frames
+    std::shared_ptr<const Topology> topology;
+    //! Staging buffer for writing
+    std::vector<char> buffer;
+    //! Precision of the compressed positions and velocities, or 0 if the
+    //! file is not compressed
+    double precision;
+    //! Position after the last frame in the file
+    uint64_t end_offset;
+    //! Number of frames written since the last keyframe
+    size_t since_keyframe;
+    //! Codecs for the positions and the velocities when writing
+    std::unique_ptr<LossyCodec> encoders[2];
+    //! Codecs for the positions and the velocities when reading
+    std::unique_ptr<LossyCodec> decoders[2];
+    //! Last step decoded by the reading codecs, or -1
+    size_t decoded;
+    //! Positions and velocities of the frames decoded before the one we read
+    Array3D scratch[2];
+};
+
+typedef concat<FORMATS_LIST, BinaryFormat>::type FormatListBinary;
+#undef FORMATS_LIST
+#define FORMATS_LIST FormatListBinary
+
+} // namespace chemfiles
+
+#endif
@@ -57,6 +57,9 @@ public:
 
     static const char* name();
     static const char* extension();
+    //! Recognize the files of this format from their first bytes, when the
+    //! format has a recognizable header.
+    static bool sniff(const std::string& header);
 private:
     /// Convert a molfile timestep to a chemfiles frame
     void molfile_to_frame(const molfile_timestep_t& timestep, Frame& frame);
@@ -80,8 +83,8 @@ private:
 
     /// Do we have topological information in this plugin ?
     mutable bool _use_topology;
-    /// Store topological information
-    mutable Topology _topology;
+    /// Store topological information, shared with all the frames
+    mutable std::shared_ptr<const Topology> _topology;
 };
 
 typedef concat<FORMATS_LIST, Molfile<PDB>>::type molfile_list_1;
@@ -0,0 +1,86 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+
+#ifndef CHEMFILES_FORMAT_MULTI_HPP
+#define CHEMFILES_FORMAT_MULTI_HPP
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "chemfiles/Format.hpp"
+#include "chemfiles/TrajectoryFactory.hpp"
+
+namespace chemfiles {
+
+class MultiFile;
+
+/*!
+ * @class MultiFormat formats/Multi.hpp formats/Multi.cpp
+ * @brief Read multiple files as a single trajectory.
+ *
+ * The steps of all the files are numbered one after the other. The number of
+ * steps in each file is computed when creating this format, using multiple
+ * threads if the format of the files supports it. The files are then only
+ * opened when reading from them, and at most \c "max_open_files" (an option
+ * with a default value of 16) are kept open at the same time.
+ *
+ * This format is not registered in the TrajectoryFactory, it is created by
+ * the Trajectory when opening a list of files or a glob pattern.
+ */
+class MultiFormat : public Format {
+public:
+    //! Create a format reading all the files in \c file, which must be a
+    //! MultiFile.
+    MultiFormat(File& file);
+    ~MultiFormat();
+
+    virtual void read_step(const size_t step, Frame& frame) override;
+    virtual void read(Frame& frame) override;
+    virtual void option(const std::string& name, double value) override;
+
+    virtual size_t nsteps() const override;
+    virtual std::string description() const override;
+private:
+    //! An underlying file, and the associated format when it is open
+    struct opened_file_t {
+        std::unique_ptr<File> file;
+        std::unique_ptr<Format> format;
+        //! Next step for sequential reading in this file
+        size_t next;
+    };
+
+    //! Compute the number of steps in each file, and the first global step
+    //! of each file.
+    void count_steps();
+    //! Get the format for the file at \c index, opening it if needed
+    Format& open(size_t index);
+    //! Close the least recently used files until at most \c max files are
+    //! still open.
+    void close_files(size_t max);
+
+    //! Reference to the associated list of files
+    MultiFile& multifile;
+    //! Builders for the file and format of each path
+    std::vector<trajectory_builder_t> builders;
+    //! First global step of each file. The last value is the total number of
+    //! steps.
+    std::vector<size_t> first_steps;
+    //! File and format for each path
+    std::vector<opened_file_t> files;
+    //! Indexes of the open files, from the most to the least recently used
+    std::list<size_t> recently_used;
+    //! Maximal number of files open at the same time
+    size_t max_open_files;
+    //! Current step for sequential reading
+    size_t step;
+};
+
+} // namespace chemfiles
+
+#endif
@@ -12,6 +12,9 @@
 #ifndef CHEMFILES_FORMAT_NC_HPP
 #define CHEMFILES_FORMAT_NC_HPP
 
+#include <utility>
+#include <netcdf>
+
 #include "chemfiles/Vector3D.hpp"
 #include "chemfiles/Format.hpp"
 #include "chemfiles/register_formats.hpp"
@@ -21,6 +24,7 @@ namespace chemfiles {
 class UnitCell;
 class Topology;
 class NCFile;
+class NC4File;
 
 /*!
  * @class NCFormat formats/NCFormat.hpp formats/NCFormat.cpp
@@ -35,11 +39,18 @@ public:
 
     virtual void read_step(const size_t step, Frame& frame) override;
     virtual void read(Frame& frame) override;
+    virtual void read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames) override;
+    virtual bool random_access() const override;
     virtual void write(const Frame& frame) override;
+    virtual bool selection(const std::vector<size_t>& atoms) override;
 
     virtual size_t nsteps() const override;
     virtual std::string description() const override;
 
+    //! Recognize NetCDF 3 and NetCDF 4 (HDF5) files. The Amber conventions
+    //! are only checked when opening the file.
+    static bool sniff(const std::string& header);
+
     using file_t = NCFile;
 
     // Register the Amber NetCDF format with the ".nc" extension and the
@@ -47,33 +58,78 @@ public:
     FORMAT_NAME(AmberNetCDF)
     FORMAT_EXTENSION(.nc)
 private:
-    //! Reserve size for \c natoms on the internal cache.
-    void reserve(size_t natoms) const;
+    //! Get the handles to the variables and the number of atoms in the file.
+    //! This is called once, when opening an existing file or after
+    //! initializing a new one.
+    void setup();
     //! Read the unit cell at the current internal step, the file is assumed to be valid.
     UnitCell read_cell() const;
-    //! Generic function to read an Array3D at the current internal step,
+    //! Read an Array3D from the variable \c var at the current internal step,
     //! the file is assumed to be valid.
-    void read_array3D(Array3D& arr, const string& name) const;
-
-    //! Write an Array3D to the file, as a variable with the name \c name, at
-    //! the current internal step.
-    void write_array3D(const Array3D& arr, const string& name) const;
+    void read_array3D(Array3D& arr, const netCDF::NcVar& var) const;
+    //! Read the unit cells of the \c count \c frames, starting at step \c first.
+    void read_cells(size_t first, size_t count, Frame* frames) const;
+    //! Read the variable \c var for the \c count \c frames starting at step
+    //! \c first, and store it in the \c array of each frame.
+    void read_arrays3D(size_t first, size_t count, Frame* frames,
+                       const netCDF::NcVar& var, Array3D& (Frame::*array)()) const;
+
+    //! Write an Array3D to the variable \c var at the current internal step.
+    void write_array3D(const Array3D& arr, const netCDF::NcVar& var) const;
     //! Write an UnitCell to the file, at the current internal step
     void write_cell(const UnitCell& cell) const;
 
     //! Reference to the associated file.
     NCFile& ncfile;
     //! Last read step
-    size_t step;
-    //! Temporary cache for read and write operations.
+    mutable size_t step;
+    //! Number of atoms in the file
+    size_t natoms;
+    //! Handle to the coordinates variable
+    netCDF::NcVar coordinates;
+    //! Handle to the velocities variable, null if the file has no velocities
+    netCDF::NcVar velocities;
+    //! Handles to the unit cell variables, null if the file has no unit cell
+    netCDF::NcVar cell_lengths;
+    netCDF::NcVar cell_angles;
+    //! Contiguous runs of selected atoms, as (first atom, number of atoms)
+    //! pairs. This is empty if all the atoms are read.
+    std::vector<std::pair<size_t, size_t>> selected_runs;
+    //! Number of selected atoms
+    size_t nselected;
+    //! Staging buffer for reading multiple frames at once
     mutable std::vector<float> cache;
     //! Was the associated file validated?
     bool validated;
 };
 
+/*!
+ * @class NC4Format formats/NCFormat.hpp formats/NCFormat.cpp
+ * @brief Amber NetCDF file format, writing compressed NetCDF 4 files.
+ *
+ * The files follow the same Amber convention as in NCFormat, but are stored
+ * using the HDF5 based NetCDF 4 format, with one chunk per frame compressed
+ * with the shuffle and deflate filters. Both formats can read these files.
+ */
+class NC4Format : public NCFormat {
+public:
+    using NCFormat::NCFormat;
+    ~NC4Format() = default;
+
+    virtual std::string description() const override;
+
+    using file_t = NC4File;
+
+    // Register the format with the "AmberNetCDF4" description only, the
+    // ".nc" extension is used by NCFormat.
+    FORMAT_NAME(AmberNetCDF4)
+    FORMAT_EXTENSION()
+};
+
 typedef concat<FORMATS_LIST, NCFormat>::type FormatListNC;
+typedef concat<FormatListNC, NC4Format>::type FormatListNC4;
 #undef FORMATS_LIST
-#define FORMATS_LIST FormatListNC
+#define FORMATS_LIST FormatListNC4
 
 } // namespace chemfiles
 
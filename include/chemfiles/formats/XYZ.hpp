@@ -10,6 +10,7 @@
 #define CHEMFILES_FORMAT_XYZ_HPP
 
 #include <string>
+#include <vector>
 
 #include "chemfiles/Format.hpp"
 #include "chemfiles/register_formats.hpp"
@@ -18,9 +19,12 @@ namespace chemfiles {
 
 /*!
  * @class XYZFormat formats/XYZ.hpp formats/XYZ.cpp
- * @brief XYZ file format reader.
+ * @brief XYZ file format reader and writer.
  *
  * The format is described at http://openbabel.org/wiki/XYZ
+ *
+ * The positions are written with a fixed number of decimals, set with the
+ * \c "precision" option (5 by default), and without trailing zeros.
  */
 class XYZFormat : public Format {
 public:
@@ -31,14 +35,26 @@ public:
     virtual void read_step(const size_t step, Frame& frame) override;
     virtual void read(Frame& frame) override;
     virtual void write(const Frame& frame) override;
+    virtual bool selection(const std::vector<size_t>& atoms) override;
+    virtual void option(const std::string& name, double value) override;
     virtual std::string description() const override;
     virtual size_t nsteps() const override;
 
+    //! Recognize files starting with a number of atoms, a comment line and
+    //! a line with an atom name and three coordinates.
+    static bool sniff(const std::string& header);
+
     // Register the xyz format with the ".xyz" extension and the "XYZ" description.
     FORMAT_NAME(XYZ)
     FORMAT_EXTENSION(.xyz)
 private:
     TextFile& textfile;
+    //! Indexes of the atoms to read, or empty to read all the atoms
+    std::vector<size_t> _selection;
+    //! Number of decimals used when writing the positions
+    unsigned _precision;
+    //! Buffer for the formatted frame when writing
+    std::string _buffer;
 };
 
 typedef concat<FORMATS_LIST, XYZFormat>::type FormatListXYZ;
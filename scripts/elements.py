@@ -23,7 +23,7 @@ class Atom:
         self.VdW = VdW
 
     def __str__(self):
-        return '{{"{}", ElementData{{{}, "{}", {}f, {}f, {}f}} }}'.format(
+        return '{{"{}", {}, "{}", {}f, {}f, {}f}}'.format(
             self.symbol, self.number, self.name, self.mass, self.cov, self.VdW)
 
 
@@ -64,10 +64,10 @@ HEADER = """/* Chemfiles, an efficient IO library for chemistry file formats
  * http://svn.code.sf.net/p/bodr/code/trunk/bodr
  */
 
-#ifndef HARP_PERIODIC_H
-#define HARP_PERIODIC_H
+#ifndef CHEMFILES_PERIODIC_H
+#define CHEMFILES_PERIODIC_H
 
-#include <map>
+#include <cstddef>
 #include <string>
 
 namespace chemfiles {
@@ -76,6 +76,8 @@ namespace chemfiles {
 STRUCT = """
 //! Storing basic elemental data: mass, colvalent and Van der Waals radii
 struct ElementData {
+    //! Element symbol
+    const char* symbol;
     //! Atomic number
     const int number;
     //! Full name
@@ -90,19 +92,91 @@ struct ElementData {
 """
 
 ARRAY = """
-static const std::map<std::string, ElementData> PERIODIC_INFORMATION = {
+//! Number of elements in the periodic table, including the dummy element
+constexpr size_t PERIODIC_TABLE_SIZE = {};
+
+//! Elemental data, indexed by atomic number
+constexpr ElementData PERIODIC_TABLE[PERIODIC_TABLE_SIZE] = {{
+"""
+
+LOOKUP = """
+//! Size of the element symbols hash table
+constexpr size_t ELEMENTS_HASH_SIZE = {size};
+
+//! Perfect hash table for element symbols, containing the atomic number of the
+//! element, or {empty} for empty slots.
+constexpr unsigned char ELEMENTS_HASH_TABLE[ELEMENTS_HASH_SIZE] = {{
+{table}
+}};
+
+//! Get the atomic number of the element with the given \\c symbol, or -1 if
+//! no element with this symbol exists.
+inline int find_element(const std::string& symbol) {{
+    if (symbol.empty() || symbol.size() > 3) {{
+        return -1;
+    }}
+    size_t c[3] = {{0, 0, 0}};
+    for (size_t i=0; i<symbol.size(); i++) {{
+        c[i] = static_cast<unsigned char>(symbol[i]);
+    }}
+    auto number = ELEMENTS_HASH_TABLE[({A} * c[0] + {B} * c[1] + {C} * c[2]) % ELEMENTS_HASH_SIZE];
+    if (number == {empty} || symbol != PERIODIC_TABLE[number].symbol) {{
+        return -1;
+    }}
+    return number;
+}}
 """
 
+EMPTY = 255
+
+
+def symbol_hash(symbol, A, B, C, size):
+    c = [ord(x) for x in symbol] + [0, 0]
+    return (A * c[0] + B * c[1] + C * c[2]) % size
+
+
+def perfect_hash(atoms):
+    """Find a collision-free hash function for the elements symbols"""
+    codes = [[ord(x) for x in atom.symbol] + [0, 0] for atom in atoms]
+    for size in range(len(atoms), 1024):
+        for A in range(1, 40):
+            for B in range(1, 40):
+                for C in [1, 2, 3, 5, 7, 11, 13]:
+                    hashes = set()
+                    for c in codes:
+                        h = (A * c[0] + B * c[1] + C * c[2]) % size
+                        if h in hashes:
+                            break
+                        hashes.add(h)
+                    else:
+                        return size, A, B, C
+    raise Exception("Could not find a perfect hash for the elements symbols")
+
+
+def write_elements(path, atoms):
+    atoms = sorted(atoms, key=lambda atom: atom.number)
+    assert all(atom.number == i for i, atom in enumerate(atoms))
+
+    size, A, B, C = perfect_hash(atoms)
 
-def write_elements(path, elements):
     f = open(path, "w")
     f.write(HEADER)
     f.write(STRUCT)
-    f.write(ARRAY)
+    f.write(ARRAY.format(len(atoms)))
     for atom in atoms:
         f.write("    " + str(atom) + ",\n")
-    f.write("};\n\n")  # closing the map.
-    f.write("} // namespace chemfiles\n\n")  # closing the namespace.
+    f.write("};\n")  # closing the array.
+
+    table = [EMPTY] * size
+    for atom in atoms:
+        table[symbol_hash(atom.symbol, A, B, C, size)] = atom.number
+    lines = []
+    for i in range(0, size, 16):
+        lines.append("    " + ", ".join(str(v) for v in table[i:i + 16]) + ",")
+    f.write(LOOKUP.format(
+        size=size, A=A, B=B, C=C, empty=EMPTY, table="\n".join(lines)
+    ))
+    f.write("\n} // namespace chemfiles\n\n")  # closing the namespace.
     f.write("#endif\n")  # closing the header guard
 
 
@@ -6,73 +6,86 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/
 */
 
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
 #include "chemfiles/Atom.hpp"
 #include "chemfiles/periodic.hpp"
 
 using namespace chemfiles;
 
-// Check if the string \c name is the name of an element
-static bool is_element(const std::string& name){
-    const auto ALL_ELEMENTS = {
-    "H" ,                                                                                                 "He",
-    "Li", "Be",                                                             "B" , "C" , "N" , "O" , "F" , "Ne",
-    "Na", "Mg",                                                             "Al", "Si", "P" , "S" , "Cl", "Ar",
-    "K" , "Ca", "Sc", "Ti", "V" , "Cr", "Mn", "Fe", "Co", "Ni", "Cu", "Zn", "Ga", "Ge", "As", "Se", "Br", "Kr",
-    "Rb", "Sr", "Y" , "Zr", "Nb", "Mo", "Tc", "Ru", "Rh", "Pd", "Ar", "Cd", "In", "Sn", "Sb", "Te", "I" , "Xe",
-    "Cs", "Ba", "La", "Hf", "Ta", "W" , "Re", "Os", "Ir", "Pt", "Au", "Hg", "Ti", "Pb", "Bi", "Po", "At", "Rn",
-    "Fr", "Ra", "Ac", "Rf", "Db", "Sg", "Bh", "Hs", "Mt", "Ds", "Rg", "Cn",
-
-    "Ce", "Pr", "Nd", "Pm", "Sm", "Eu", "Gd", "Tb", "Dy", "Ho", "Er", "Tm", "Yb", "Lu",
-    "Th", "Pa", "U" , "Np", "Pu", "Am", "Cm", "Bk", "Cf", "Es", "Fm", "Md", "No", "Lr"
-    };
-    for (auto& element: ALL_ELEMENTS){
-        if (name == element) {
-            return true;
-        }
+// Number of interned names cached by each thread
+static constexpr size_t INTERN_CACHE_SIZE = 64;
+
+// Get the interned version of \c name. The strings are stored in an
+// unordered_set, which never moves its elements in memory. The set is never
+// destroyed, so that atoms can still be used during static destruction.
+static const std::string* intern(const std::string& name) {
+    // Most files only use a few dozen names, which are found in the cache of
+    // this thread without taking the lock. Each name has a single slot in the
+    // cache, given by its hash. The cache only contains pointers, and can be
+    // used at any time, even after the thread-local destructors ran.
+    static thread_local const std::string* cache[INTERN_CACHE_SIZE] = {};
+    auto& cached = cache[std::hash<std::string>()(name) % INTERN_CACHE_SIZE];
+    if (cached != nullptr && *cached == name) {
+        return cached;
     }
-    return false;
+
+    static auto names = new std::unordered_set<std::string>();
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    cached = &*names->insert(name).first;
+    return cached;
 }
 
-Atom::Atom(const std::string& name) : _name(name), _mass(0), _charge(0) {
-    if (is_element(name)) {
+Atom::Atom(const std::string& name) : _name(intern(name)), _element(find_element(name)), _mass(0), _charge(0) {
+    if (_element > 0) {
         _type = ELEMENT;
     } else {
         _type = CORSE_GRAIN;
     }
 
-    if (PERIODIC_INFORMATION.find(name) != PERIODIC_INFORMATION.end()){
-        _mass = PERIODIC_INFORMATION.at(name).mass ;
+    if (_element != -1) {
+        _mass = PERIODIC_TABLE[_element].mass;
     }
 }
 
-Atom::Atom(AtomType type, const std::string& name) : _name(name), _mass(0), _charge(0), _type(type){}
+Atom::Atom(AtomType type, const std::string& name)
+: _name(intern(name)), _element(find_element(name)), _mass(0), _charge(0), _type(type) {}
 
 Atom::Atom() : Atom(UNDEFINED) {}
 
+void Atom::name(const std::string& name) {
+    _name = intern(name);
+    _element = find_element(name);
+}
+
 std::string Atom::full_name() const {
-    if (PERIODIC_INFORMATION.find(_name) != PERIODIC_INFORMATION.end()){
-        return std::string(PERIODIC_INFORMATION.at(_name).name) ;
+    if (_element != -1) {
+        return std::string(PERIODIC_TABLE[_element].name);
     }
     return "";
 }
 
 float Atom::vdw_radius() const {
-    if (PERIODIC_INFORMATION.find(_name) != PERIODIC_INFORMATION.end()){
-        return PERIODIC_INFORMATION.at(_name).vdw_radius ;
+    if (_element != -1) {
+        return PERIODIC_TABLE[_element].vdw_radius;
     }
     return -1;
 }
 
 float Atom::covalent_radius() const {
-    if (PERIODIC_INFORMATION.find(_name) != PERIODIC_INFORMATION.end()){
-        return PERIODIC_INFORMATION.at(_name).colvalent_radius ;
+    if (_element != -1) {
+        return PERIODIC_TABLE[_element].colvalent_radius;
     }
     return -1;
 }
 
 int Atom::atomic_number() const {
-    if (PERIODIC_INFORMATION.find(_name) != PERIODIC_INFORMATION.end()){
-        return PERIODIC_INFORMATION.at(_name).number ;
+    if (_element != -1) {
+        return PERIODIC_TABLE[_element].number;
     }
     return -1;
 }
@@ -0,0 +1,178 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <algorithm>
+#include <cmath>
+
+#include "chemfiles/Codec.hpp"
+#include "chemfiles/Error.hpp"
+using namespace chemfiles;
+
+// Number of values sharing the same number of bits
+static const size_t BLOCK_SIZE = 128;
+// Maximal absolute value of the quantized values, so that all the differences
+// fit in 32-bit integers.
+static const double MAX_QUANTIZED = 1 << 30;
+
+static uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// Pack the \c count \c values in blocks of BLOCK_SIZE values. Each block
+// starts with the number of bits of its largest value, followed by all the
+// values using this number of bits.
+static void pack(const uint32_t* values, size_t count, std::vector<char>& output) {
+    for (size_t start=0; start<count; start+=BLOCK_SIZE) {
+        auto size = std::min(BLOCK_SIZE, count - start);
+        uint32_t all = 0;
+        for (size_t i=0; i<size; i++) {
+            all |= values[start + i];
+        }
+        unsigned width = 0;
+        while (width < 32 && (all >> width) != 0) {
+            width++;
+        }
+
+        auto position = output.size();
+        output.resize(position + 1 + (size * width + 7) / 8);
+        auto out = reinterpret_cast<unsigned char*>(&output[position]);
+        *out++ = static_cast<unsigned char>(width);
+
+        uint64_t buffer = 0;
+        unsigned bits = 0;
+        for (size_t i=0; i<size; i++) {
+            buffer |= static_cast<uint64_t>(values[start + i]) << bits;
+            bits += width;
+            while (bits >= 8) {
+                *out++ = static_cast<unsigned char>(buffer);
+                buffer >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits != 0) {
+            *out++ = static_cast<unsigned char>(buffer);
+        }
+    }
+}
+
+// Unpack \c count values packed by \c pack from \c data
+static void unpack(const char* data, size_t size, uint32_t* values, size_t count) {
+    auto input = reinterpret_cast<const unsigned char*>(data);
+    auto end = input + size;
+    for (size_t start=0; start<count; start+=BLOCK_SIZE) {
+        auto block = std::min(BLOCK_SIZE, count - start);
+        if (input >= end) {
+            throw FormatError("Corrupted compressed data: unexpected end of data.");
+        }
+        unsigned width = *input++;
+        if (width > 32 || static_cast<size_t>(end - input) < (block * width + 7) / 8) {
+            throw FormatError("Corrupted compressed data: invalid block.");
+        }
+
+        auto mask = width == 32 ? 0xFFFFFFFFu : (1u << width) - 1;
+        uint64_t buffer = 0;
+        unsigned bits = 0;
+        for (size_t i=0; i<block; i++) {
+            while (bits < width) {
+                buffer |= static_cast<uint64_t>(*input++) << bits;
+                bits += 8;
+            }
+            values[start + i] = static_cast<uint32_t>(buffer) & mask;
+            buffer >>= width;
+            bits -= width;
+        }
+    }
+}
+
+LossyCodec::LossyCodec(double precision): _precision(precision) {
+    if (!(precision > 0)) {
+        throw Error("The precision of a codec must be positive, got " + std::to_string(precision) + ".");
+    }
+}
+
+void LossyCodec::encode(const Array3D& array, bool keyframe, std::vector<char>& output) {
+    auto count = 3 * array.size();
+    if (!keyframe && _previous.size() != count) {
+        throw Error("Can not delta-encode arrays with different sizes, use a keyframe.");
+    }
+
+    // Quantize and compute the residuals, updating the previous values
+    _previous.resize(count);
+    _residuals.resize(count);
+    auto scale = 1.0 / _precision;
+    int32_t last[3] = {0, 0, 0};
+    for (size_t i=0; i<array.size(); i++) {
+        for (size_t j=0; j<3; j++) {
+            auto scaled = std::round(static_cast<double>(array[i][j]) * scale);
+            if (!(std::fabs(scaled) < MAX_QUANTIZED)) {
+                throw FormatError(
+                    "Can not compress the value " + std::to_string(array[i][j]) +
+                    " with a precision of " + std::to_string(_precision) + "."
+                );
+            }
+            auto quantized = static_cast<int32_t>(scaled);
+            auto index = 3 * i + j;
+            if (keyframe) {
+                _residuals[index] = zigzag(quantized - last[j]);
+                last[j] = quantized;
+            } else {
+                _residuals[index] = zigzag(quantized - _previous[index]);
+            }
+            _previous[index] = quantized;
+        }
+    }
+
+    // Number of vectors, in little-endian order
+    auto size = static_cast<uint64_t>(array.size());
+    for (size_t i=0; i<sizeof(uint64_t); i++) {
+        output.push_back(static_cast<char>(size >> (8 * i)));
+    }
+    pack(_residuals.data(), count, output);
+}
+
+void LossyCodec::decode(const char* data, size_t size, bool keyframe, Array3D& array) {
+    if (size < sizeof(uint64_t)) {
+        throw FormatError("Corrupted compressed data: unexpected end of data.");
+    }
+    uint64_t natoms = 0;
+    for (size_t i=0; i<sizeof(uint64_t); i++) {
+        natoms |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    if (natoms > (size - sizeof(uint64_t)) * BLOCK_SIZE) {
+        // Each block of values needs at least one byte
+        throw FormatError("Corrupted compressed data: invalid number of values.");
+    }
+    auto count = static_cast<size_t>(3 * natoms);
+    if (!keyframe && _previous.size() != count) {
+        throw FormatError("Corrupted compressed data: the number of values changed.");
+    }
+
+    _residuals.resize(count);
+    unpack(data + sizeof(uint64_t), size - sizeof(uint64_t), _residuals.data(), count);
+
+    _previous.resize(count);
+    array.resize(static_cast<size_t>(natoms));
+    int32_t last[3] = {0, 0, 0};
+    for (size_t i=0; i<array.size(); i++) {
+        for (size_t j=0; j<3; j++) {
+            auto index = 3 * i + j;
+            int32_t quantized;
+            if (keyframe) {
+                quantized = last[j] + unzigzag(_residuals[index]);
+                last[j] = quantized;
+            } else {
+                quantized = _previous[index] + unzigzag(_residuals[index]);
+            }
+            _previous[index] = quantized;
+            array[i][j] = static_cast<float>(quantized * _precision);
+        }
+    }
+}
@@ -19,6 +19,35 @@ void Format::read(Frame&){
     throw FormatError("Not implemented function 'read'");
 }
 
+void Format::read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames) {
+    frames.resize((last - first + stride - 1) / stride);
+    if (frames.empty()) {
+        return;
+    }
+    // Only go to the first step once, and then read sequentially: going to a
+    // step is linear in the step index for formats without an index.
+    read_step(first, frames[0]);
+    Frame skipped;
+    for (size_t i=1; i<frames.size(); i++) {
+        for (size_t j=1; j<stride; j++) {
+            read(skipped);
+        }
+        read(frames[i]);
+    }
+}
+
+bool Format::random_access() const {
+    return false;
+}
+
+bool Format::selection(const std::vector<size_t>&) {
+    return false;
+}
+
+void Format::option(const std::string& name, double){
+    throw FormatError("Unknown option '" + name + "' for this format.");
+}
+
 void Format::write(const Frame&){
     throw FormatError("Not implemented function 'write'");
 }
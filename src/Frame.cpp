@@ -5,23 +5,80 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/
 */
+#include <algorithm>
 #include <iostream>
 
 #include "chemfiles/Frame.hpp"
+#include "chemfiles/NeighborList.hpp"
 #include "chemfiles/Logger.hpp"
 #include "chemfiles/Error.hpp"
 using namespace chemfiles;
 
 Frame::Frame() : Frame(0) {}
 
-Frame::Frame(size_t natoms) : _step(0), _topology(natoms), _cell() {
-    resize(natoms);
+Frame::Frame(size_t natoms) : Frame(Topology(natoms)) {}
+
+Frame::Frame(Topology top, bool has_velocities) : _step(0), _modifiable(nullptr), _cell() {
+    auto topology = std::make_shared<Topology>(std::move(top));
+    _modifiable = topology.get();
+    _topology = std::move(topology);
+    resize(_topology->natoms(), has_velocities);
+}
+
+Frame::Frame(const Frame& other)
+: _step(other._step), _positions(other._positions), _velocities(other._velocities),
+  _topology(other._topology), _modifiable(nullptr), _cell(other._cell) {
+    if (other._modifiable != nullptr) {
+        // References to the topology of the other frame may still be used to
+        // modify it, so it can not be shared
+        topology(*other._topology);
+    }
+}
+
+Frame& Frame::operator=(const Frame& other) {
+    if (this == &other) {
+        return *this;
+    }
+    _step = other._step;
+    _positions = other._positions;
+    _velocities = other._velocities;
+    if (other._modifiable != nullptr) {
+        topology(*other._topology);
+    } else {
+        _topology = other._topology;
+        _modifiable = nullptr;
+    }
+    _cell = other._cell;
+    return *this;
+}
+
+Topology& Frame::topology() {
+    // Only modify the topology in place if no one else uses it, and if it
+    // was not given as a const object
+    if (_topology.use_count() != 1 || _modifiable == nullptr) {
+        topology(*_topology);
+    }
+    return *_modifiable;
+}
+
+void Frame::topology(const Topology& top) {
+    auto copy = std::make_shared<Topology>(top);
+    _modifiable = copy.get();
+    _topology = std::move(copy);
+}
+
+void Frame::topology(std::shared_ptr<const Topology> top) {
+    if (!top) {
+        throw Error("Can not use a null topology in a frame.");
+    }
+    _topology = std::move(top);
+    _modifiable = nullptr;
 }
 
 void Frame::raw_positions(float pos[][3], size_t size) const{
     if (size < _positions.size())
         throw MemoryError("Too small array passed to get_raw_positions.");
-    for (size_t i = 0; i<size; i++) {
+    for (size_t i = 0; i<_positions.size(); i++) {
         for (size_t j = 0; j<3; j++) {
             pos[i][j] = _positions[i][j];
         }
@@ -37,7 +94,7 @@ void Frame::raw_velocities(float vel[][3], size_t size) const{
                 vel[i][j] = 0;
     }
     else {
-        for (size_t i = 0; i<size; i++)
+        for (size_t i = 0; i<_velocities.size(); i++)
             for (size_t j = 0; j<3; j++)
                 vel[i][j] = _velocities[i][j];
     }
@@ -73,24 +130,44 @@ void Frame::guess_topology(bool please_guess_bonds) {
     if (please_guess_bonds) {
         guess_bonds();
     }
-    _topology.recalculate();
+    topology().recalculate();
 }
 
 void Frame::guess_bonds() {
+    auto& topology = this->topology();
+    double max_radius = 0;
     for (size_t i=0; i<natoms(); i++) {
-        float irad = _topology[i].covalent_radius();
-        if (irad == -1) {
-            throw Error("Missing covalent radius for the atom " + _topology[i].name());
+        float rad = topology[i].covalent_radius();
+        if (rad == -1) {
+            throw Error("Missing covalent radius for the atom " + topology[i].name());
         }
-        for (size_t j=0; j<natoms(); j++) {
-            float jrad = _topology[j].covalent_radius();
-            if (jrad == -1) {
-                throw Error("Missing covalent radius for the atom " + _topology[j].name());
-            }
-            double d = norm(_cell.wrap(_positions[i] - _positions[j]));
-            if (d > 0.4 && d < irad + jrad + 0.56) { // This criterium comes from Rasmol
-                _topology.add_bond(i, j);
+        max_radius = std::max(max_radius, static_cast<double>(rad));
+    }
+
+    // This criterium comes from Rasmol
+    auto neighbors = NeighborList(2 * max_radius + 0.56);
+    if (!neighbors.fits(_cell)) {
+        // The cell is too small for the neighbor list, use the minimum image
+        // of all the pairs instead.
+        for (size_t i=0; i<natoms(); i++) {
+            float irad = topology[i].covalent_radius();
+            for (size_t j=i+1; j<natoms(); j++) {
+                float jrad = topology[j].covalent_radius();
+                double d = norm(_cell.wrap(_positions[i] - _positions[j]));
+                if (d > 0.4 && d < irad + jrad + 0.56) {
+                    topology.add_bond(i, j);
+                }
             }
         }
+        return;
+    }
+
+    neighbors.compute(*this);
+    for (auto& pair: neighbors.pairs()) {
+        float irad = topology[pair.i].covalent_radius();
+        float jrad = topology[pair.j].covalent_radius();
+        if (pair.distance > 0.4 && pair.distance < irad + jrad + 0.56) {
+            topology.add_bond(pair.i, pair.j);
+        }
     }
 }
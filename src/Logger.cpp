@@ -8,82 +8,90 @@
 
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 #include "chemfiles/Logger.hpp"
 using namespace chemfiles;
 
-// No-op buffer for no-op stream
-class NullBuffer : public std::streambuf {
-public:
-  int overflow(int c) { return c; }
-};
-
-static NullBuffer nullbuff;
-// nullstream is a no-op ostream.
-static std::ostream nullstream(&nullbuff);
+// Protect the log stream, which is shared by all the threads
+static std::mutex mutex;
 
 // Singleton instance
 Logger Logger::instance{};
 
-Logger::Logger() : current_level(WARNING), os(&std::clog), is_file(false) {}
-
-Logger::~Logger(){
-    close();
+// Buffer used to format the messages of the current thread. Only complete
+// messages are written to the shared log stream.
+static std::ostringstream& thread_buffer() {
+    static thread_local std::ostringstream buffer;
+    return buffer;
 }
 
-std::ostream& Logger::out(LogLevel level){
-    return instance.get_stream(level);
-}
-
-std::ostream& Logger::get_stream(LogLevel level){
-    // Don't write anything if the out level is less important than
-    // the current level, or if the current level is NONE.
-    if (level > current_level || current_level == NONE)
-        return nullstream;
-
+Logger::Message::Message(LogLevel level): _stream(thread_buffer()) {
     switch(level){
         case ERROR:
-            *os << "Chemfiles error: ";
+            _stream << "Chemfiles error: ";
             break;
         case WARNING:
-            *os << "Chemfiles warning: ";
+            _stream << "Chemfiles warning: ";
             break;
         case INFO:
-            *os << "Chemfiles info: ";
+            _stream << "Chemfiles info: ";
             break;
         case DEBUG:
-            *os << "Chemfiles debug: ";
+            _stream << "Chemfiles debug: ";
             break;
         case NONE:
             break;
     }
-    return *os;
 }
 
+Logger::Message::~Message() {
+    auto& buffer = thread_buffer();
+    instance.write(buffer.str());
+    buffer.str(std::string());
+    buffer.clear();
+}
+
+Logger::Logger() : current_level(WARNING), os(&std::clog), is_file(false) {}
+
+Logger::~Logger(){
+    close();
+}
+
+void Logger::write(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    *os << message;
+    os->flush();
+}
 
 void Logger::level(LogLevel level){
-    instance.current_level = level;
+    instance.current_level.store(level, std::memory_order_relaxed);
 }
 
 void Logger::log_to_stdout(){
+    std::lock_guard<std::mutex> lock(mutex);
     instance.close();
     instance.is_file = false;
     instance.os = &std::cout;
 }
 
 void Logger::log_to_stderr(){
+    std::lock_guard<std::mutex> lock(mutex);
     instance.close();
     instance.is_file = false;
     instance.os = &std::cerr;
 }
 
 void Logger::log_to_stdlog(){
+    std::lock_guard<std::mutex> lock(mutex);
     instance.close();
     instance.is_file = false;
     instance.os = &std::clog;
 }
 
 void Logger::log_to_file(const std::string &filename){
+    std::lock_guard<std::mutex> lock(mutex);
     instance.close();
     instance.is_file = true;
     instance.os = new std::ofstream(filename, std::ofstream::out);
@@ -0,0 +1,396 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "chemfiles/NeighborList.hpp"
+#include "chemfiles/Frame.hpp"
+#include "chemfiles/Error.hpp"
+using namespace chemfiles;
+
+// Systems smaller than this are always handled by a single thread
+static constexpr size_t MIN_ATOMS_PER_THREAD = 2048;
+
+// Call function(begin, end, thread) on \c nthreads contiguous chunks of [0, size)
+template <typename Function>
+static void parallel_for(size_t size, size_t nthreads, Function function) {
+    nthreads = std::min(nthreads, size / MIN_ATOMS_PER_THREAD);
+    if (nthreads <= 1) {
+        function(0, size, 0);
+        return;
+    }
+
+    auto chunk = (size + nthreads - 1) / nthreads;
+    std::vector<std::thread> workers;
+    for (size_t t=0; t<nthreads; t++) {
+        auto begin = t * chunk;
+        auto end = std::min(size, begin + chunk);
+        workers.emplace_back(function, begin, end, t);
+    }
+    for (auto& worker: workers) {
+        worker.join();
+    }
+}
+
+// Squared distance between two points given by their fractional coordinates,
+// using the minimal image convention along the periodic directions.
+static double distance2(const std::array<double, 3>& a, const std::array<double, 3>& b,
+                        const double (&matrix)[3][3], const bool (&periodic)[3]) {
+    double ds[3];
+    for (size_t k=0; k<3; k++) {
+        ds[k] = b[k] - a[k];
+        if (periodic[k]) {
+            ds[k] -= std::round(ds[k]);
+        }
+    }
+    double d2 = 0;
+    for (size_t k=0; k<3; k++) {
+        auto dr = matrix[k][0] * ds[0] + matrix[k][1] * ds[1] + matrix[k][2] * ds[2];
+        d2 += dr * dr;
+    }
+    return d2;
+}
+
+NeighborList::NeighborList(double cutoff, double skin)
+: _cutoff(cutoff), _skin(skin), _threads(0), _rebuilds(0), _natoms(0), _cell() {
+    if (cutoff <= 0) {
+        throw Error("The cutoff of a neighbor list must be positive.");
+    }
+    if (skin < 0) {
+        throw Error("The skin of a neighbor list can not be negative.");
+    }
+    threads(0);
+}
+
+void NeighborList::threads(size_t n) {
+    if (n == 0) {
+        n = std::max(1u, std::thread::hardware_concurrency());
+    }
+    _threads = n;
+}
+
+size_t NeighborList::size() const {
+    return _selection.empty() ? _natoms : _selection.size();
+}
+
+void NeighborList::compute(const Frame& frame) {
+    rebuild(frame, {});
+}
+
+void NeighborList::compute(const Frame& frame, const std::vector<size_t>& selection) {
+    auto sorted = selection;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.empty()) {
+        // Using an empty selection is not the same as using all the atoms
+        _selection.clear();
+        _natoms = frame.natoms();
+        _cell = frame.cell();
+        _candidates.clear();
+        _pairs.clear();
+        _reference.clear();
+        _rebuilds++;
+        return;
+    }
+    rebuild(frame, std::move(sorted));
+}
+
+void NeighborList::update(const Frame& frame) {
+    if (_rebuilds == 0 || frame.natoms() != _natoms || !(frame.cell() == _cell)) {
+        rebuild(frame, _selection);
+        return;
+    }
+
+    auto& positions = frame.positions();
+    double max2 = 0;
+    for (size_t i=0; i<_reference.size(); i++) {
+        max2 = std::max(max2, norm2(positions[index(i)] - _reference[i]));
+    }
+
+    if (4 * max2 > _skin * _skin) {
+        rebuild(frame, _selection);
+    } else {
+        fractional(positions);
+        filter();
+    }
+}
+
+void NeighborList::fractional(const Array3D& positions) {
+    _fractional.resize(size());
+    parallel_for(size(), _threads, [&](size_t begin, size_t end, size_t) {
+        for (size_t i=begin; i<end; i++) {
+            auto& r = positions[index(i)];
+            for (size_t k=0; k<3; k++) {
+                _fractional[i][k] = _inverse[k][0] * r[0] + _inverse[k][1] * r[1] + _inverse[k][2] * r[2];
+            }
+        }
+    });
+}
+
+// Geometry of a unit cell, as used by the neighbor list
+struct cell_geometry_t {
+    // Cell matrix, with the cell vectors as columns
+    double matrix[3][3];
+    // Inverse of the cell matrix
+    double inverse[3][3];
+    // Periodicity of the three cell directions
+    bool periodic[3];
+    // Distance between the two faces of the cell in each direction
+    double widths[3];
+};
+
+// Get the geometry of \c cell. Infinite cells, or cells without volume, are
+// represented by the identity matrix.
+static cell_geometry_t cell_geometry(const UnitCell& cell) {
+    cell_geometry_t geometry;
+    if (cell.type() == UnitCell::INFINITE || cell.volume() == 0) {
+        for (size_t i=0; i<3; i++) {
+            for (size_t j=0; j<3; j++) {
+                geometry.matrix[i][j] = (i == j) ? 1 : 0;
+                geometry.inverse[i][j] = (i == j) ? 1 : 0;
+            }
+            geometry.periodic[i] = false;
+            geometry.widths[i] = 1;
+        }
+        return geometry;
+    }
+
+    auto matrix = cell.matricial();
+    for (size_t i=0; i<3; i++) {
+        for (size_t j=0; j<3; j++) {
+            geometry.matrix[i][j] = matrix[j][i];
+        }
+    }
+    geometry.periodic[0] = cell.periodic_x();
+    geometry.periodic[1] = cell.periodic_y();
+    geometry.periodic[2] = cell.periodic_z();
+
+    auto& m = geometry.matrix;
+    auto det = m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2])
+             - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+             + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    // Cofactors of the cell matrix. The i-th row of the inverse is the
+    // cross product of the two other cell vectors, divided by the volume.
+    for (size_t i=0; i<3; i++) {
+        auto j = (i + 1) % 3;
+        auto k = (i + 2) % 3;
+        double cross[3] = {
+            m[1][j] * m[2][k] - m[2][j] * m[1][k],
+            m[2][j] * m[0][k] - m[0][j] * m[2][k],
+            m[0][j] * m[1][k] - m[1][j] * m[0][k],
+        };
+        auto area = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+        geometry.widths[i] = std::fabs(det) / area;
+        for (size_t l=0; l<3; l++) {
+            geometry.inverse[i][l] = cross[l] / det;
+        }
+    }
+    return geometry;
+}
+
+// Check that \c range is smaller than half the width of the cell described
+// by \c geometry in all the periodic directions
+static bool range_fits(const cell_geometry_t& geometry, double range) {
+    for (size_t k=0; k<3; k++) {
+        if (geometry.periodic[k] && 2 * range > geometry.widths[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NeighborList::fits(const UnitCell& cell) const {
+    return range_fits(cell_geometry(cell), _cutoff + _skin);
+}
+
+void NeighborList::rebuild(const Frame& frame, std::vector<size_t> selection) {
+    // Check everything before modifying the list, so that a failed rebuild
+    // leaves the list in its previous state.
+    for (auto i: selection) {
+        if (i >= frame.natoms()) {
+            throw Error("Out of bounds index " + std::to_string(i) + " in neighbor list selection.");
+        }
+    }
+    auto geometry = cell_geometry(frame.cell());
+    auto range = _cutoff + _skin;
+    if (!range_fits(geometry, range)) {
+        throw Error("The neighbor list cutoff (" + std::to_string(range) +
+                    " including the skin) is bigger than half the unit cell width.");
+    }
+
+    _rebuilds++;
+    _selection = std::move(selection);
+    _natoms = frame.natoms();
+    _cell = frame.cell();
+    for (size_t i=0; i<3; i++) {
+        for (size_t j=0; j<3; j++) {
+            _matrix[i][j] = geometry.matrix[i][j];
+            _inverse[i][j] = geometry.inverse[i][j];
+        }
+        _periodic[i] = geometry.periodic[i];
+    }
+
+    auto& positions = frame.positions();
+    auto natoms = size();
+    _reference.resize(natoms);
+    for (size_t i=0; i<natoms; i++) {
+        _reference[i] = positions[index(i)];
+    }
+    fractional(positions);
+
+    // Get the extent of the system in fractional coordinates, and wrap the
+    // periodic directions in [0, 1)
+    double lower[3] = {0, 0, 0};
+    double extent[3] = {1, 1, 1};
+    for (size_t k=0; k<3; k++) {
+        if (_periodic[k]) {
+            for (auto& s: _fractional) {
+                s[k] -= std::floor(s[k]);
+            }
+        } else if (natoms != 0) {
+            auto minmax = std::minmax_element(_fractional.begin(), _fractional.end(),
+                [k](const std::array<double, 3>& a, const std::array<double, 3>& b) {
+                    return a[k] < b[k];
+                }
+            );
+            lower[k] = (*minmax.first)[k];
+            extent[k] = (*minmax.second)[k] - lower[k];
+        }
+    }
+
+    // Create bins at least as wide as the cutoff in all directions, without
+    // using much more bins than atoms.
+    size_t nbins[3];
+    for (size_t k=0; k<3; k++) {
+        auto n = std::floor(extent[k] * geometry.widths[k] / range);
+        nbins[k] = static_cast<size_t>(std::max(1.0, std::min(n, static_cast<double>(natoms) + 1)));
+    }
+    while (nbins[0] * nbins[1] * nbins[2] > 2 * natoms + 27) {
+        auto k = static_cast<size_t>(std::max_element(nbins, nbins + 3) - nbins);
+        nbins[k] = std::max<size_t>(1, nbins[k] / 2);
+    }
+    auto ncells = nbins[0] * nbins[1] * nbins[2];
+
+    // Sort the atoms by bin
+    std::vector<size_t> bin_of(natoms);
+    std::vector<size_t> start(ncells + 1, 0);
+    for (size_t i=0; i<natoms; i++) {
+        size_t bin[3];
+        for (size_t k=0; k<3; k++) {
+            auto s = extent[k] > 0 ? (_fractional[i][k] - lower[k]) / extent[k] : 0;
+            bin[k] = std::min(nbins[k] - 1, static_cast<size_t>(std::max(0.0, s * static_cast<double>(nbins[k]))));
+        }
+        bin_of[i] = (bin[0] * nbins[1] + bin[1]) * nbins[2] + bin[2];
+        start[bin_of[i] + 1]++;
+    }
+    for (size_t c=0; c<ncells; c++) {
+        start[c + 1] += start[c];
+    }
+    std::vector<size_t> sorted(natoms);
+    auto position = start;
+    for (size_t i=0; i<natoms; i++) {
+        sorted[position[bin_of[i]]++] = i;
+    }
+
+    // Search the pairs in neighboring bins
+    auto range2 = range * range;
+    std::vector<std::vector<neighbor_pair>> found(_threads);
+    parallel_for(ncells, _threads, [&](size_t begin, size_t end, size_t thread) {
+        auto& pairs = found[thread];
+        std::vector<size_t> neighbors;
+        for (size_t cell=begin; cell<end; cell++) {
+            size_t bin[3] = {cell / (nbins[1] * nbins[2]), (cell / nbins[2]) % nbins[1], cell % nbins[2]};
+
+            neighbors.clear();
+            for (int dx=-1; dx<=1; dx++) {
+            for (int dy=-1; dy<=1; dy++) {
+            for (int dz=-1; dz<=1; dz++) {
+                int delta[3] = {dx, dy, dz};
+                size_t other[3];
+                bool valid = true;
+                for (size_t k=0; k<3; k++) {
+                    auto n = static_cast<long>(nbins[k]);
+                    auto b = static_cast<long>(bin[k]) + delta[k];
+                    if (_periodic[k]) {
+                        b = ((b % n) + n) % n;
+                    } else if (b < 0 || b >= n) {
+                        valid = false;
+                    }
+                    other[k] = static_cast<size_t>(b);
+                }
+                auto id = (other[0] * nbins[1] + other[1]) * nbins[2] + other[2];
+                // Every couple of bins is only visited once
+                if (valid && id >= cell) {
+                    neighbors.push_back(id);
+                }
+            }}}
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+            for (auto other: neighbors) {
+                for (size_t a=start[cell]; a<start[cell + 1]; a++) {
+                    auto first = (other == cell) ? a + 1 : start[other];
+                    for (size_t b=first; b<start[other + 1]; b++) {
+                        auto i = sorted[a];
+                        auto j = sorted[b];
+                        auto d2 = distance2(_fractional[i], _fractional[j], _matrix, _periodic);
+                        if (d2 < range2) {
+                            auto ii = index(i);
+                            auto jj = index(j);
+                            pairs.push_back({std::min(ii, jj), std::max(ii, jj), std::sqrt(d2)});
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    _candidates.clear();
+    for (auto& pairs: found) {
+        _candidates.insert(_candidates.end(), pairs.begin(), pairs.end());
+    }
+
+    _pairs.clear();
+    for (auto& pair: _candidates) {
+        if (pair.distance < _cutoff) {
+            _pairs.push_back(pair);
+        }
+    }
+}
+
+void NeighborList::filter() {
+    // Map from frame indexes to indexes in _fractional
+    std::vector<size_t> local;
+    if (!_selection.empty()) {
+        local.assign(_natoms, 0);
+        for (size_t i=0; i<_selection.size(); i++) {
+            local[_selection[i]] = i;
+        }
+    }
+
+    std::vector<std::vector<neighbor_pair>> found(_threads);
+    parallel_for(_candidates.size(), _threads, [&](size_t begin, size_t end, size_t thread) {
+        auto& pairs = found[thread];
+        for (size_t n=begin; n<end; n++) {
+            auto& pair = _candidates[n];
+            auto i = local.empty() ? pair.i : local[pair.i];
+            auto j = local.empty() ? pair.j : local[pair.j];
+            pair.distance = std::sqrt(distance2(_fractional[i], _fractional[j], _matrix, _periodic));
+            if (pair.distance < _cutoff) {
+                pairs.push_back(pair);
+            }
+        }
+    });
+
+    _pairs.clear();
+    for (auto& pairs: found) {
+        _pairs.insert(_pairs.end(), pairs.begin(), pairs.end());
+    }
+}
@@ -0,0 +1,188 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+* Copyright (C) 2015 Guillaume Fraux
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <algorithm>
+#include <cstring>
+
+#include "chemfiles/TimeSeries.hpp"
+#include "chemfiles/Trajectory.hpp"
+#include "chemfiles/Error.hpp"
+#include "chemfiles/files/RawFile.hpp"
+using namespace chemfiles;
+
+// Magic number at the start of all the files
+static const char MAGIC[8] = {'C', 'H', 'F', 'L', 'T', 'S', 'E', 'R'};
+// Version of the file format
+static const uint32_t VERSION = 1;
+// Size of the header: magic number, version, reserved space, number of atoms
+// and number of steps.
+static const uint64_t HEADER_SIZE = 32;
+// Size of a single position
+static const uint64_t POSITION_SIZE = 3 * sizeof(float);
+// Number of atoms transposed together
+static const size_t ATOMS_BLOCK = 64;
+// Memory used by the frames of a tile, when the tile size is chosen from the
+// number of atoms
+static const size_t TILE_MEMORY = 128 * 1024 * 1024;
+
+static bool is_little_endian() {
+    const uint16_t value = 1;
+    char first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+// Encode the \c size bytes of \c value in little-endian order at \c output
+static void encode(char* output, const void* value, size_t size) {
+    std::memcpy(output, value, size);
+    if (!is_little_endian()) {
+        std::reverse(output, output + size);
+    }
+}
+
+// Decode a little-endian value from \c input
+template <typename T>
+static T decode(const char* input) {
+    T value = 0;
+    for (size_t i=0; i<sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<unsigned char>(input[i])) << (8 * i);
+    }
+    return value;
+}
+
+void TimeSeries::transpose(Trajectory& trajectory, const std::string& path) {
+    size_t tile = 1;
+    if (trajectory.nsteps() != 0) {
+        // Account for the memory used by the frames themselves, which
+        // dominates for very small systems
+        auto natoms = trajectory.read_step(0).natoms();
+        auto frame_size = natoms * POSITION_SIZE + sizeof(Frame);
+        tile = std::max<size_t>(TILE_MEMORY / frame_size, 1);
+    }
+    transpose(trajectory, path, tile);
+}
+
+void TimeSeries::transpose(Trajectory& trajectory, const std::string& path, size_t tile) {
+    if (tile == 0) {
+        throw Error("The tile size for transposing a trajectory can not be 0.");
+    }
+    RawFile file(path, "w");
+    auto nsteps = trajectory.nsteps();
+
+    std::vector<Frame> frames;
+    std::vector<char> buffer;
+    size_t natoms = 0;
+    for (size_t first=0; first<nsteps; first+=tile) {
+        auto last = std::min(first + tile, nsteps);
+        trajectory.read_block(first, last, 1, frames);
+        if (first == 0) {
+            natoms = frames[0].natoms();
+        }
+        for (auto& frame: frames) {
+            if (frame.natoms() != natoms) {
+                throw Error(
+                    "Can not transpose a trajectory with different numbers of atoms: found " +
+                    std::to_string(frame.natoms()) + " atoms instead of " + std::to_string(natoms) + "."
+                );
+            }
+        }
+
+        // Transpose blocks of atoms small enough to stay in the CPU cache,
+        // reading the frames memory in order.
+        auto tile_size = frames.size() * POSITION_SIZE;
+        for (size_t block=0; block<natoms; block+=ATOMS_BLOCK) {
+            auto block_natoms = std::min(ATOMS_BLOCK, natoms - block);
+            buffer.resize(block_natoms * tile_size);
+            for (size_t i=0; i<frames.size(); i++) {
+                const auto& positions = frames[i].positions();
+                for (size_t atom=0; atom<block_natoms; atom++) {
+                    auto output = &buffer[atom * tile_size + i * POSITION_SIZE];
+                    for (size_t j=0; j<3; j++) {
+                        encode(output + j * sizeof(float), &positions[block + atom][j], sizeof(float));
+                    }
+                }
+            }
+
+            if (frames.size() == nsteps) {
+                // All the steps are in this tile, the atoms are contiguous
+                auto offset = HEADER_SIZE + block * tile_size;
+                file.write(offset, buffer.data(), buffer.size());
+            } else {
+                for (size_t atom=0; atom<block_natoms; atom++) {
+                    auto offset = HEADER_SIZE + ((block + atom) * nsteps + first) * POSITION_SIZE;
+                    file.write(offset, &buffer[atom * tile_size], tile_size);
+                }
+            }
+        }
+    }
+
+    char header[HEADER_SIZE] = {0};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    encode(header + 8, &VERSION, sizeof(uint32_t));
+    auto header_natoms = static_cast<uint64_t>(natoms);
+    auto header_nsteps = static_cast<uint64_t>(nsteps);
+    encode(header + 16, &header_natoms, sizeof(uint64_t));
+    encode(header + 24, &header_nsteps, sizeof(uint64_t));
+    file.write(0, header, HEADER_SIZE);
+    file.sync();
+}
+
+TimeSeries::TimeSeries(const std::string& path): _file(new RawFile(path, "r")), _natoms(0), _nsteps(0) {
+    if (_file->size() < HEADER_SIZE) {
+        throw FormatError("The file " + path + " is not a chemfiles time series file.");
+    }
+    auto header = _file->read(0, HEADER_SIZE);
+    if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        throw FormatError("The file " + path + " is not a chemfiles time series file.");
+    }
+    auto version = decode<uint32_t>(header + 8);
+    if (version != VERSION) {
+        throw FormatError(
+            "Unsupported version " + std::to_string(version) + " of the chemfiles time series file " + path + "."
+        );
+    }
+    auto natoms = decode<uint64_t>(header + 16);
+    auto nsteps = decode<uint64_t>(header + 24);
+    if (nsteps != 0 && natoms > (_file->size() - HEADER_SIZE) / (nsteps * POSITION_SIZE)) {
+        throw FormatError("The time series file " + path + " is too small for its content.");
+    }
+    _natoms = static_cast<size_t>(natoms);
+    _nsteps = static_cast<size_t>(nsteps);
+}
+
+TimeSeries::TimeSeries(TimeSeries&&) = default;
+TimeSeries& TimeSeries::operator=(TimeSeries&&) = default;
+TimeSeries::~TimeSeries() = default;
+
+Array3D TimeSeries::positions(size_t atom) {
+    Array3D result;
+    positions(atom, result);
+    return result;
+}
+
+void TimeSeries::positions(size_t atom, Array3D& positions) {
+    if (atom >= _natoms) {
+        throw Error(
+            "Can not read the atom " + std::to_string(atom) + " in a time series with " +
+            std::to_string(_natoms) + " atoms."
+        );
+    }
+    positions.resize(_nsteps);
+    if (_nsteps == 0) {
+        return;
+    }
+
+    auto size = static_cast<size_t>(_nsteps * POSITION_SIZE);
+    auto data = _file->read(HEADER_SIZE + atom * size, size);
+    std::memcpy(positions[0].data(), data, size);
+    if (!is_little_endian()) {
+        auto bytes = reinterpret_cast<char*>(positions[0].data());
+        for (size_t i=0; i<3 * _nsteps; i++) {
+            std::reverse(bytes + i * sizeof(float), bytes + (i + 1) * sizeof(float));
+        }
+    }
+}
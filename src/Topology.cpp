@@ -101,18 +101,27 @@ Topology::Topology(size_t natoms) {
 
 Topology::Topology() : Topology(0) {}
 
-void Topology::append(const Atom& _atom){
-    size_t index = static_cast<size_t>(-1);
-
-    for (size_t i = 0 ; i<_templates.size(); i++)
-        if (_templates[i] == _atom)
-            index = i;
-    if (index == static_cast<size_t>(-1)) { // Atom not found
-        _templates.push_back(_atom);
-        index = _templates.size() - 1;
+size_t Topology::template_index(const Atom& atom) {
+    auto it = _templates_index.find(atom);
+    if (it != _templates_index.end() && !(_templates[it->second] == atom)) {
+        // A template was modified through operator[], rebuild the index
+        _templates_index.clear();
+        for (size_t i=0; i<_templates.size(); i++) {
+            _templates_index[_templates[i]] = i;
+        }
+        it = _templates_index.find(atom);
     }
 
-    _atoms.push_back(index);
+    if (it == _templates_index.end()) { // Atom not found
+        _templates.push_back(atom);
+        _templates_index.emplace(atom, _templates.size() - 1);
+        return _templates.size() - 1;
+    }
+    return it->second;
+}
+
+void Topology::append(const Atom& _atom){
+    _atoms.push_back(template_index(_atom));
 }
 
 void Topology::remove(size_t idx) {
@@ -144,32 +153,61 @@ vector<dihedral> Topology::dihedrals() const{
     return res;
 }
 
+// Copy the elements of \c set in the C-style array \c data, with \c size rows
+template <size_t N, class T>
+static void copy_raw(const std::unordered_set<T>& set, size_t data[][N], size_t size, const char* name) {
+    if (size < set.size()) {
+        throw MemoryError(std::string("Too small array passed to ") + name + ".");
+    }
+    size_t i = 0;
+    for (auto& value: set) {
+        for (size_t j = 0; j<N; j++) {
+            data[i][j] = value[j];
+        }
+        i++;
+    }
+}
+
+void Topology::raw_bonds(size_t data[][2], size_t size) const {
+    copy_raw<2>(_connect.bonds(), data, size, "raw_bonds");
+}
+
+void Topology::raw_angles(size_t data[][3], size_t size) const {
+    copy_raw<3>(_connect.angles(), data, size, "raw_angles");
+}
+
+void Topology::raw_dihedrals(size_t data[][4], size_t size) const {
+    copy_raw<4>(_connect.dihedrals(), data, size, "raw_dihedrals");
+}
+
 bool Topology::isbond(size_t i, size_t j) const  {
-    auto bonds = _connect.bonds();
+    auto& bonds = _connect.bonds();
     auto pos = bonds.find(bond(i, j));
     return pos != end(bonds);
 }
 
 bool Topology::isangle(size_t i, size_t j, size_t k) const {
-    auto angles = _connect.angles();
+    auto& angles = _connect.angles();
     auto pos = angles.find(angle(i, j, k));
     return pos != end(angles);
 }
 
 bool Topology::isdihedral(size_t i, size_t j, size_t k, size_t m) const {
-    auto dihedrals = _connect.dihedrals();
+    auto& dihedrals = _connect.dihedrals();
     auto pos = dihedrals.find(dihedral(i, j, k, m));
     return pos != end(dihedrals);
 }
 
 void Topology::clear(){
     _templates.clear();
+    _templates_index.clear();
     _atoms.clear();
     _connect.clear();
 }
 
 Topology chemfiles::dummy_topology(size_t natoms){
     Topology top(0);
+    top.reserve(natoms);
     for (size_t i=0; i<natoms; i++)
         top.append(Atom(Atom::UNDEFINED));
     return top;
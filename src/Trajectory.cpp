@@ -6,33 +6,69 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/
 */
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include "chemfiles/config.hpp"
+#ifndef CHFL_WINDOWS
+#include <glob.h>
+#endif
+
 #include "chemfiles/Trajectory.hpp"
 #include "chemfiles/TrajectoryFactory.hpp"
 #include "chemfiles/Logger.hpp"
 #include "chemfiles/files/BasicFile.hpp"
+#include "chemfiles/files/MultiFile.hpp"
+#include "chemfiles/formats/Multi.hpp"
 
 using namespace chemfiles;
 using std::string;
 
-//! Get the extension part of a filename. Filename is assumed to be valid here.
-static string extension(const string& filename) {
-    auto idx = filename.rfind('.');
+// Is \c filename a glob pattern and not the name of an existing file?
+static bool is_glob(const string& filename) {
+    if (filename.find_first_of("*?[") == string::npos) {
+        return false;
+    }
+    return !std::ifstream(filename).good();
+}
 
-    if(idx != std::string::npos) {
-        return filename.substr(idx);
-    } else {
-        return "";
+// Get all the paths matching the glob \c pattern, sorted by name
+static std::vector<string> expand_glob(const string& pattern) {
+    std::vector<string> paths;
+#ifdef CHFL_WINDOWS
+    throw FileError("Glob patterns are not supported on Windows, can not open " + pattern + ".");
+#else
+    glob_t result;
+    auto status = glob(pattern.c_str(), 0, nullptr, &result);
+    if (status == 0) {
+        for (size_t i=0; i<result.gl_pathc; i++) {
+            paths.emplace_back(result.gl_pathv[i]);
+        }
+    }
+    globfree(&result);
+    if (status == GLOB_NOMATCH) {
+        throw FileError("No file matching the pattern " + pattern + ".");
+    } else if (status != 0) {
+        throw FileError("Could not expand the pattern " + pattern + ".");
     }
+#endif
+    return paths;
 }
 
 Trajectory::Trajectory(const string& filename, const string& mode, const string& format)
-: _step(0), _nsteps(0), _topology(), _use_custom_topology(false), _cell(), _use_custom_cell(false)
+: _step(0), _nsteps(0), _topology(nullptr), _use_custom_topology(false), _cell(),
+  _use_custom_cell(false), _selection(), _format_selection(false)
 {
+    if (mode == "r" && is_glob(filename)) {
+        open_files(filename, expand_glob(filename), format);
+        return;
+    }
+
     trajectory_builder_t builder;
     if (format == ""){
-        // try to guess the format by extension
-        auto ext = extension(filename);
-        builder = TrajectoryFactory::get().by_extension(ext);
+        // try to guess the format by extension, or by content
+        builder = TrajectoryFactory::get().guess(filename, mode);
     }
     else {
         builder = TrajectoryFactory::get().format(format);
@@ -45,8 +81,67 @@ Trajectory::Trajectory(const string& filename, const string& mode, const string&
         _nsteps = _format->nsteps();
 }
 
+Trajectory::Trajectory(const std::vector<string>& filenames, const string& format)
+: _step(0), _nsteps(0), _topology(nullptr), _use_custom_topology(false), _cell(),
+  _use_custom_cell(false), _selection(), _format_selection(false)
+{
+    if (filenames.empty()) {
+        throw FileError("Can not open a trajectory without any file.");
+    }
+    auto name = filenames[0];
+    if (filenames.size() > 1) {
+        name += " and " + std::to_string(filenames.size() - 1) + " other files";
+    }
+    open_files(name, filenames, format);
+}
+
+void Trajectory::open_files(const string& name, std::vector<string> paths, const string& format) {
+    _file.reset(new MultiFile(name, std::move(paths), format));
+    _format.reset(new MultiFormat(*_file));
+    _nsteps = _format->nsteps();
+}
+
+Trajectory::Trajectory(Trajectory&&) = default;
+
+Trajectory& Trajectory::operator=(Trajectory&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    // The format may still use the file in its destructor, so it must be
+    // destroyed first.
+    _format.reset();
+    _file = std::move(other._file);
+    _format = std::move(other._format);
+    _step = other._step;
+    _nsteps = other._nsteps;
+    _topology = std::move(other._topology);
+    _use_custom_topology = other._use_custom_topology;
+    _cell = other._cell;
+    _use_custom_cell = other._use_custom_cell;
+    _selection = std::move(other._selection);
+    _format_selection = other._format_selection;
+    _last_topology = std::move(other._last_topology);
+    _last_selected_topology = std::move(other._last_selected_topology);
+    _counters = std::move(other._counters);
+    return *this;
+}
+
 Trajectory::~Trajectory(){}
 
+template <class Function>
+void Trajectory::with_format(Function function) {
+    if (!_counters) {
+        function();
+        return;
+    }
+    // The time spent in the file during the call is already counted
+    auto file_time = _counters->file_time;
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    _counters->format_time += elapsed.count() - (_counters->file_time - file_time);
+}
+
 Trajectory& Trajectory::operator>>(Frame& frame){
     frame = read();
     return *this;
@@ -61,17 +156,10 @@ Frame Trajectory::read(){
     }
 
     Frame frame;
-    _format->read(frame);
+    with_format([&](){_format->read(frame);});
     _step++;
 
-    // Set the frame topology if needed
-    if (_use_custom_topology)
-        frame.topology(_topology);
-
-    // Set the frame unit cell if needed
-    if (_use_custom_cell)
-        frame.cell(_cell);
-
+    post_read(frame);
     return frame;
 }
 
@@ -87,8 +175,41 @@ Frame Trajectory::read_step(const size_t step){
     }
 
     Frame frame;
-    _step = step;
-    _format->read_step(_step, frame);
+    with_format([&](){_format->read_step(step, frame);});
+    _step = step + 1;
+
+    post_read(frame);
+    return frame;
+}
+
+void Trajectory::read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames) {
+    if (stride == 0) {
+        throw Error("The stride for reading a block of steps can not be 0.");
+    }
+    if (first > last || last > _nsteps) {
+        throw FileError(
+            "Can not read file \"" + _file->filename() + "\" from step " +
+            std::to_string(first) + " to step " + std::to_string(last) +
+            ". Max step is " + std::to_string(_nsteps) + "."
+        );
+    }
+    if (!(_file->mode() == "r" || _file->mode() == "a")) {
+        throw FileError("File \"" + _file->filename() + "\" was not openened in read or append mode.");
+    }
+
+    with_format([&](){_format->read_block(first, last, stride, frames);});
+    _step = last;
+
+    for (auto& frame: frames) {
+        post_read(frame);
+    }
+}
+
+void Trajectory::post_read(Frame& frame) {
+    if (_counters) {
+        _counters->frames_read++;
+    }
+    CounterTimer timer(_counters.get(), &Counters::post_processing_time);
 
     // Set the frame topology if needed
     if (_use_custom_topology)
@@ -98,7 +219,98 @@ Frame Trajectory::read_step(const size_t step){
     if (_use_custom_cell)
         frame.cell(_cell);
 
-    return frame;
+    if (!_selection.empty()) {
+        select_atoms(frame, !_format_selection);
+    }
+}
+
+// Get the subset of \c topology containing only the atoms in \c selection, and
+// the bonds between these atoms.
+static Topology select_topology(const Topology& topology, const std::vector<size_t>& selection) {
+    auto natoms = topology.natoms();
+    auto npos = static_cast<size_t>(-1);
+    std::vector<size_t> new_indexes(natoms, npos);
+
+    Topology selected;
+    selected.reserve(selection.size());
+    for (size_t i=0; i<selection.size(); i++) {
+        if (selection[i] >= natoms) {
+            throw Error(
+                "Can not select the atom " + std::to_string(selection[i]) +
+                " in a topology with " + std::to_string(natoms) + " atoms."
+            );
+        }
+        new_indexes[selection[i]] = i;
+        selected.append(topology[selection[i]]);
+    }
+
+    for (auto& bond: topology.bonds()) {
+        auto i = new_indexes[bond[0]];
+        auto j = new_indexes[bond[1]];
+        if (i != npos && j != npos) {
+            selected.add_bond(i, j);
+        }
+    }
+    selected.recalculate();
+    return selected;
+}
+
+// Only keep the values at the indexes in \c selection in \c array
+static void select_array(Array3D& array, const std::vector<size_t>& selection) {
+    if (array.empty()) {
+        return;
+    }
+    if (selection.back() >= array.size()) {
+        throw Error(
+            "Can not select the atom " + std::to_string(selection.back()) +
+            " in a frame with " + std::to_string(array.size()) + " atoms."
+        );
+    }
+    // The selection is sorted, so this never overwrites a value before using it
+    for (size_t i=0; i<selection.size(); i++) {
+        array[i] = array[selection[i]];
+    }
+    array.resize(selection.size());
+}
+
+void Trajectory::select_atoms(Frame& frame, bool positions) {
+    if (positions) {
+        select_array(frame.positions(), _selection);
+        select_array(frame.velocities(), _selection);
+    }
+
+    // Formats reading only the selected atoms already give the selected
+    // topology, unless we are using a custom topology.
+    if (positions || _use_custom_topology) {
+        auto topology = frame.shared_topology();
+        if (topology->natoms() == 0) {
+            return; // No topology to select from
+        }
+        if (topology != _last_topology) {
+            _last_topology = topology;
+            _last_selected_topology = std::make_shared<Topology>(select_topology(*topology, _selection));
+        }
+        frame.topology(_last_selected_topology);
+    }
+}
+
+void Trajectory::selection(std::vector<size_t> atoms) {
+    std::sort(atoms.begin(), atoms.end());
+    atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+    _format_selection = _format->selection(atoms);
+    _selection = std::move(atoms);
+    _last_topology = nullptr;
+    _last_selected_topology = nullptr;
+}
+
+void Trajectory::option(const std::string& name, double value) {
+    _format->option(name, value);
+}
+
+std::vector<Frame> Trajectory::read_block(size_t first, size_t last, size_t stride) {
+    std::vector<Frame> frames;
+    read_block(first, last, stride, frames);
+    return frames;
 }
 
 Trajectory& Trajectory::operator<<(const Frame& frame){
@@ -111,22 +323,28 @@ void Trajectory::write(const Frame& input_frame){
         throw FileError("File \"" + _file->filename() + "\" was not openened in write or append mode.");
     }
 
-    // Maybe that is not the better way to do this, performance-wise. I'll have
-    // to benchmark this part.
-    Frame frame = input_frame;
-    if (_use_custom_topology)
-        frame.topology(_topology);
-    if (_use_custom_cell)
-        frame.cell(_cell);
-
-    _format->write(frame);
+    if (_use_custom_topology || _use_custom_cell) {
+        // Copying the frame only copies the positions and velocities, the
+        // topology is shared
+        Frame frame = input_frame;
+        if (_use_custom_topology)
+            frame.topology(_topology);
+        if (_use_custom_cell)
+            frame.cell(_cell);
+        with_format([&](){_format->write(frame);});
+    } else {
+        with_format([&](){_format->write(input_frame);});
+    }
+    if (_counters) {
+        _counters->frames_written++;
+    }
     _step++;
     _nsteps++;
 }
 
 void Trajectory::topology(const Topology& top){
     _use_custom_topology = true;
-    _topology = top;
+    _topology = std::make_shared<Topology>(top);
 }
 
 void Trajectory::topology(const std::string& filename) {
@@ -134,7 +352,8 @@ void Trajectory::topology(const std::string& filename) {
     assert(topolgy_file.nsteps() > 0);
 
     auto frame = topolgy_file.read_step(0);
-    Trajectory::topology(frame.topology());
+    _use_custom_topology = true;
+    _topology = frame.shared_topology();
 }
 
 void Trajectory::cell(const UnitCell& new_cell){
@@ -142,6 +361,30 @@ void Trajectory::cell(const UnitCell& new_cell){
     _cell = new_cell;
 }
 
+void Trajectory::enable_counters() {
+    _counters.reset(new Counters());
+    _file->counters(_counters.get());
+}
+
+Counters Trajectory::counters() const {
+    if (_counters) {
+        return *_counters;
+    } else {
+        return Counters();
+    }
+}
+
+void Trajectory::log_counters() const {
+    auto counters = this->counters();
+    LOG(INFO) << "Counters for " << _file->filename() << ": "
+              << counters.frames_read << " frames read, "
+              << counters.frames_written << " frames written, "
+              << counters.bytes_read << " bytes read, "
+              << counters.file_time << " s in files, "
+              << counters.format_time << " s in formats, "
+              << counters.post_processing_time << " s in post-processing" << std::endl;
+}
+
 void Trajectory::sync() {
     _file->sync();
 }
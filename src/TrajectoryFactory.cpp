@@ -5,20 +5,36 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/
 */
+#include <algorithm>
+#include <fstream>
+
 #include "chemfiles/TrajectoryFactory.hpp"
 
 #include "chemfiles/formats/XYZ.hpp"
 #include "chemfiles/formats/NCFormat.hpp"
 #include "chemfiles/formats/Molfile.hpp"
+#include "chemfiles/formats/Binary.hpp"
 
 #include "chemfiles/files/NCFile.hpp"
+#include "chemfiles/files/RawFile.hpp"
 using namespace chemfiles;
 
 typedef FORMATS_LIST formats_list;
+using sniffers_t = std::vector<std::pair<string, trajectory_builder_t>>;
+
+constexpr size_t TrajectoryFactory::SNIFF_SIZE;
 
+// Check if a format hides Format::sniff to recognize its files
 template <typename T>
-inline void register_all_formats(trajectory_map_t& formats, trajectory_map_t& extensions, FormatList<T>) {
-    auto creator = trajectory_builder_t{new_format<T>, new_file<typename T::file_t>};
+static sniffer_t get_sniffer() {
+    return &T::sniff == &Format::sniff ? nullptr : &T::sniff;
+}
+
+template <typename T>
+inline void register_all_formats(trajectory_map_t& formats, trajectory_map_t& extensions, sniffers_t& sniffers, FormatList<T>) {
+    auto creator = trajectory_builder_t{
+        new_format<T>, new_file<typename T::file_t>, T::file_t::thread_safe, get_sniffer<T>()
+    };
 
     auto ext = std::string(T::extension());
     if (ext != ""){
@@ -34,17 +50,20 @@ inline void register_all_formats(trajectory_map_t& formats, trajectory_map_t& ex
             throw FormatError("The name \"" + name + "\" is already associated with a format.");
         }
         formats.emplace(name, creator);
+        if (creator.sniff) {
+            sniffers.emplace_back(name, creator);
+        }
     }
 }
 
 template <typename T, typename S, typename ...Types>
-inline void register_all_formats(trajectory_map_t& formats, trajectory_map_t& extensions, FormatList<T, S, Types...>) {
-    register_all_formats(formats, extensions, FormatList<T>());
-    register_all_formats(formats, extensions, FormatList<S, Types...>());
+inline void register_all_formats(trajectory_map_t& formats, trajectory_map_t& extensions, sniffers_t& sniffers, FormatList<T, S, Types...>) {
+    register_all_formats(formats, extensions, sniffers, FormatList<T>());
+    register_all_formats(formats, extensions, sniffers, FormatList<S, Types...>());
 }
 
-TrajectoryFactory::TrajectoryFactory() : formats(), extensions() {
-    register_all_formats(formats, extensions, formats_list());
+TrajectoryFactory::TrajectoryFactory() : formats(), extensions(), sniffers() {
+    register_all_formats(formats, extensions, sniffers, formats_list());
 }
 
 TrajectoryFactory& TrajectoryFactory::get() {
@@ -66,11 +85,81 @@ trajectory_builder_t TrajectoryFactory::by_extension(const string& ext){
     return extensions[ext];
 }
 
+// Get the extension part of a path, or an empty string
+static string extension(const string& path) {
+    auto idx = path.rfind('.');
+    if (idx != string::npos) {
+        return path.substr(idx);
+    } else {
+        return "";
+    }
+}
+
+// Get the name of the compression used by the file starting with \c header,
+// or an empty string.
+static string compression(const string& header) {
+    if (header.compare(0, 2, "\x1f\x8b") == 0) {
+        return "gzip";
+    } else if (header.compare(0, 3, "BZh") == 0) {
+        return "bzip2";
+    } else if (header.compare(0, 6, "\xfd" "7zXZ\0", 6) == 0) {
+        return "xz";
+    } else {
+        return "";
+    }
+}
+
+trajectory_builder_t TrajectoryFactory::by_content(const string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw FileError("Could not open the file " + path + " to guess its format.");
+    }
+    string header(SNIFF_SIZE, '\0');
+    file.read(&header[0], static_cast<std::streamsize>(SNIFF_SIZE));
+    header.resize(static_cast<size_t>(file.gcount()));
+
+    for (auto& sniffer: sniffers) {
+        if (sniffer.second.sniff(header)) {
+            return sniffer.second;
+        }
+    }
+
+    auto compressed = compression(header);
+    if (!compressed.empty()) {
+        throw FormatError(
+            "The file " + path + " is compressed with " + compressed +
+            ", which is not supported. Please decompress it first."
+        );
+    }
+    throw FormatError("Can not find a format recognizing the content of the file " + path + ".");
+}
+
+trajectory_builder_t TrajectoryFactory::guess(const string& path, const string& mode) {
+    auto ext = extension(path);
+    if (extensions.find(ext) == extensions.end() && mode != "w" && std::ifstream(path)) {
+        return by_content(path);
+    }
+    return by_extension(ext);
+}
+
+std::vector<string> TrajectoryFactory::names() const {
+    std::vector<string> result;
+    result.reserve(formats.size());
+    for (auto& format: formats) {
+        result.push_back(format.first);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 void TrajectoryFactory::register_format(const string& name, trajectory_builder_t tb){
     if (formats.find(name) != formats.end()) {
         throw FormatError("The name \"" + name + "\" is already associated with a format.");
     }
     formats.emplace(name, tb);
+    if (tb.sniff) {
+        sniffers.emplace_back(name, tb);
+    }
 }
 
 void TrajectoryFactory::register_extension(const string& ext, trajectory_builder_t tb){
@@ -15,11 +15,11 @@ using namespace chemfiles;
 using std::string;
 
 const char* chfl_strerror(int code){
-    return status.message(code);
+    return CAPIStatus::message(code);
 }
 
 const char* chfl_last_error(){
-    return status.last_error.c_str();
+    return CAPIStatus::last_error().c_str();
 }
 
 int chfl_loglevel(chfl_log_level_t* level) {
@@ -108,6 +108,24 @@ int chfl_trajectory_nsteps(CHFL_TRAJECTORY *file, size_t *nsteps){
     )
 }
 
+int chfl_trajectory_enable_counters(CHFL_TRAJECTORY *file){
+    CHFL_ERROR_WRAP_RETCODE(
+        file->enable_counters();
+    )
+}
+
+int chfl_trajectory_counters(const CHFL_TRAJECTORY *file, chfl_counters_t *counters){
+    CHFL_ERROR_WRAP_RETCODE(
+        auto values = file->counters();
+        counters->bytes_read = values.bytes_read;
+        counters->frames_read = values.frames_read;
+        counters->frames_written = values.frames_written;
+        counters->file_time = values.file_time;
+        counters->format_time = values.format_time;
+        counters->post_processing_time = values.post_processing_time;
+    )
+}
+
 int chfl_trajectory_sync(CHFL_TRAJECTORY *file){
     CHFL_ERROR_WRAP_RETCODE(
         file->sync();
@@ -155,6 +173,18 @@ int chfl_frame_set_positions(CHFL_FRAME* frame, float const (*data)[3], size_t s
     )
 }
 
+int chfl_frame_positions_data(CHFL_FRAME* frame, float (**data)[3], size_t* size){
+    CHFL_ERROR_WRAP_RETCODE(
+        auto& positions = frame->positions();
+        *size = positions.size();
+        if (positions.empty()) {
+            *data = nullptr;
+        } else {
+            *data = reinterpret_cast<float (*)[3]>(positions[0].data());
+        }
+    )
+}
+
 int chfl_frame_velocities(const CHFL_FRAME* frame, float (*data)[3], size_t size){
     CHFL_ERROR_WRAP_RETCODE(
         frame->raw_velocities(data, size);
@@ -173,6 +203,18 @@ int chfl_frame_set_velocities(CHFL_FRAME* frame, float const (*data)[3], size_t
     )
 }
 
+int chfl_frame_velocities_data(CHFL_FRAME* frame, float (**data)[3], size_t* size){
+    CHFL_ERROR_WRAP_RETCODE(
+        auto& velocities = frame->velocities();
+        *size = velocities.size();
+        if (velocities.empty()) {
+            *data = nullptr;
+        } else {
+            *data = reinterpret_cast<float (*)[3]>(velocities[0].data());
+        }
+    )
+}
+
 int chfl_frame_has_velocities(const CHFL_FRAME* frame, bool *has_vel)  {
     CHFL_ERROR_WRAP_RETCODE(
         *has_vel = frame->has_velocities();
@@ -327,7 +369,7 @@ int chfl_cell_free(CHFL_CELL* cell) {
 
 /******************************************************************************/
 
-CHFL_TOPOLOGY* chfl_topology_from_frame(CHFL_FRAME* frame){
+CHFL_TOPOLOGY* chfl_topology_from_frame(const CHFL_FRAME* frame){
     CHFL_TOPOLOGY* topology = NULL;
     CHFL_ERROR_WRAP(
         topology = new Topology();
@@ -394,66 +436,75 @@ int chfl_topology_isdihedral(const CHFL_TOPOLOGY* topology, size_t i, size_t j,
 
 int chfl_topology_bonds_count(const CHFL_TOPOLOGY* topology, size_t* nbonds){
     CHFL_ERROR_WRAP_RETCODE(
-        *nbonds = topology->bonds().size();
+        *nbonds = topology->nbonds();
     )
 }
 
 int chfl_topology_angles_count(const CHFL_TOPOLOGY* topology, size_t* nangles){
     CHFL_ERROR_WRAP_RETCODE(
-        *nangles = topology->angles().size();
+        *nangles = topology->nangles();
     )
 }
 
 int chfl_topology_dihedrals_count(const CHFL_TOPOLOGY* topology, size_t* ndihedrals){
     CHFL_ERROR_WRAP_RETCODE(
-        *ndihedrals = topology->dihedrals().size();
+        *ndihedrals = topology->ndihedrals();
     )
 }
 
 int chfl_topology_bonds(const CHFL_TOPOLOGY* topology, size_t (*data)[2], size_t nbonds){
-    if (nbonds != topology->bonds().size()){
-        status.last_error = "Wrong data size in function 'chfl_topology_bonds'.";
+    if (nbonds != topology->nbonds()){
+        CAPIStatus::set_last_error("Wrong data size in function 'chfl_topology_bonds'.");
         return CAPIStatus::MEMORY;
     }
 
-    auto bonds = topology->bonds();
     CHFL_ERROR_WRAP_RETCODE(
-        for (size_t i = 0; i<nbonds; i++){
-            data[i][0] = bonds[i][0];
-            data[i][1] = bonds[i][1];
-        }
+        topology->raw_bonds(data, nbonds);
     )
 }
 
 int chfl_topology_angles(const CHFL_TOPOLOGY* topology, size_t (*data)[3], size_t nangles){
-    if (nangles != topology->angles().size()){
-        status.last_error = "Wrong data size in function 'chfl_topology_angles'.";
+    if (nangles != topology->nangles()){
+        CAPIStatus::set_last_error("Wrong data size in function 'chfl_topology_angles'.");
         return CAPIStatus::MEMORY;
     }
 
-    auto angles = topology->angles();
     CHFL_ERROR_WRAP_RETCODE(
-        for (size_t i = 0; i<nangles; i++){
-            data[i][0] = angles[i][0];
-            data[i][1] = angles[i][1];
-            data[i][2] = angles[i][2];
-        }
+        topology->raw_angles(data, nangles);
     )
 }
 
 int chfl_topology_dihedrals(const CHFL_TOPOLOGY* topology, size_t (*data)[4], size_t ndihedrals){
-    if (ndihedrals != topology->dihedrals().size()){
-        status.last_error = "Wrong data size in function 'chfl_topology_bonds'.";
+    if (ndihedrals != topology->ndihedrals()){
+        CAPIStatus::set_last_error("Wrong data size in function 'chfl_topology_dihedrals'.");
         return CAPIStatus::MEMORY;
     }
 
-    auto dihedrals = topology->dihedrals();
     CHFL_ERROR_WRAP_RETCODE(
-        for (size_t i = 0; i<ndihedrals; i++){
-            data[i][0] = dihedrals[i][0];
-            data[i][1] = dihedrals[i][1];
-            data[i][2] = dihedrals[i][2];
-            data[i][3] = dihedrals[i][3];
+        topology->raw_dihedrals(data, ndihedrals);
+    )
+}
+
+int chfl_topology_connectivity(const CHFL_TOPOLOGY* topology,
+                               size_t (*bonds)[2], size_t nbonds,
+                               size_t (*angles)[3], size_t nangles,
+                               size_t (*dihedrals)[4], size_t ndihedrals){
+    if ((bonds && nbonds != topology->nbonds()) ||
+        (angles && nangles != topology->nangles()) ||
+        (dihedrals && ndihedrals != topology->ndihedrals())) {
+        CAPIStatus::set_last_error("Wrong data size in function 'chfl_topology_connectivity'.");
+        return CAPIStatus::MEMORY;
+    }
+
+    CHFL_ERROR_WRAP_RETCODE(
+        if (bonds) {
+            topology->raw_bonds(bonds, nbonds);
+        }
+        if (angles) {
+            topology->raw_angles(angles, nangles);
+        }
+        if (dihedrals) {
+            topology->raw_dihedrals(dihedrals, ndihedrals);
         }
     )
 }
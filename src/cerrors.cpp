@@ -0,0 +1,70 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+* Copyright (C) 2015 Guillaume Fraux
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include "chemfiles/cerrors.hpp"
+#include "chemfiles/Error.hpp"
+#include "chemfiles/Logger.hpp"
+using namespace chemfiles;
+
+static const char* MESSAGES[CAPIStatus::LAST] = {
+    "Operation was sucessfull",
+    "Error in C++ runtime. Use chfl_last_error for more informations.",
+    "Error in chemfiles library. Use chfl_last_error for more informations.",
+    "Memory error.",
+    "Error while reading a file.",
+    "Error while reading a format.",
+};
+
+// Each thread has its own error message, so that functions called from
+// different threads do not overwrite each other errors.
+static thread_local std::string LAST_ERROR;
+
+const char* CAPIStatus::message(int i) {
+    if (i >= 0 && i < LAST) {
+        return MESSAGES[i];
+    } else {
+        return "";
+    }
+}
+
+const std::string& CAPIStatus::last_error() {
+    return LAST_ERROR;
+}
+
+void CAPIStatus::set_last_error(const std::string& message) {
+    LAST_ERROR = message;
+}
+
+// The errors are handled out of line, to keep the code of the C API functions
+// small and the path without errors fast.
+int CAPIStatus::handle_exception() {
+    try {
+        throw;
+    } catch (const FileError& e) {
+        set_last_error(e.what());
+        LOG(ERROR) << e.what() << std::endl;
+        return FILE;
+    } catch (const MemoryError& e) {
+        set_last_error(e.what());
+        LOG(ERROR) << e.what() << std::endl;
+        return MEMORY;
+    } catch (const FormatError& e) {
+        set_last_error(e.what());
+        LOG(ERROR) << e.what() << std::endl;
+        return FORMAT;
+    } catch (const Error& e) {
+        set_last_error(e.what());
+        LOG(ERROR) << e.what() << std::endl;
+        return CHEMHARP;
+    } catch (const std::exception& e) {
+        set_last_error(e.what());
+        return STD_ERROR;
+    } catch (...) {
+        set_last_error("Unknown error.");
+        return STD_ERROR;
+    }
+}
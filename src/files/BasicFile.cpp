@@ -37,16 +37,24 @@ const std::string& BasicFile::getline(){
 }
 
 BasicFile& BasicFile::operator>>(std::string& line){
+    CounterTimer timer(counters(), &Counters::file_time);
     std::getline(stream, line);
+    if (counters()) {
+        counters()->bytes_read += line.size() + 1;
+    }
     return *this;
 }
 
 const std::vector<std::string>& BasicFile::readlines(size_t n){
+    CounterTimer timer(counters(), &Counters::file_time);
     lines.resize(n);
     std::string line;
     for (size_t i=0; i<n; i++){
         std::getline(stream, line);
         lines[i] = line;
+        if (counters()) {
+            counters()->bytes_read += line.size() + 1;
+        }
     }
 
     if (!stream)
@@ -8,8 +8,6 @@
 #include "chemfiles/config.hpp"
 #if HAVE_NETCDF
 
-#include <cassert>
-
 #include "chemfiles/files/NCFile.hpp"
 #include "chemfiles/Error.hpp"
 #include "chemfiles/Logger.hpp"
@@ -17,20 +15,29 @@ using namespace chemfiles;
 using namespace netCDF;
 using std::string;
 
-NCFile::NCFile(const std::string& filename, const string& mode): BinaryFile(filename, mode){
+NCFile::NCFile(const std::string& filename, const string& mode): NCFile(filename, mode, false) {}
+
+NCFile::NCFile(const std::string& filename, const string& mode, bool netcdf4)
+: BinaryFile(filename, mode), _netcdf4(false) {
+    auto format = netcdf4 ? NcFile::nc4 : NcFile::classic64;
     try {
         if (mode == "r"){
             file.open(filename, NcFile::read);
         } else if (mode == "a"){
-            file.open(filename, NcFile::write, NcFile::classic64);
+            file.open(filename, NcFile::write, format);
         } else if (mode == "w"){
-            file.open(filename, NcFile::replace, NcFile::classic64);
+            file.open(filename, NcFile::replace, format);
         } else {
             throw FileError("Unknown mode for file opening: " + mode);
         }
     } catch (const netCDF::exceptions::NcException& e) {
         throw FileError("Could not open the file " + filename + ".\n   " + e.what());
     }
+
+    // Existing files keep their own format
+    int file_format = 0;
+    nc_inq_format(file.getId(), &file_format);
+    _netcdf4 = (file_format == NC_FORMAT_NETCDF4);
 }
 
 string NCFile::global_attribute(const string& attname) const {
@@ -74,6 +81,22 @@ NcVar NCFile::variable(const string& varname) const {
     return var;
 }
 
+bool NCFile::has_variable(const string& varname) const {
+    try {
+        return !file.getVar(varname).isNull();
+    } catch (const netCDF::exceptions::NcException&) {
+        return false;
+    }
+}
+
+bool NCFile::has_dimension(const string& dimname) const {
+    try {
+        return !file.getDim(dimname).isNull();
+    } catch (const netCDF::exceptions::NcException&) {
+        return false;
+    }
+}
+
 /******************************************************************************/
 
 void NCFile::add_global_attribute(const string& attname, const string& value) {
@@ -96,18 +119,41 @@ void NCFile::add_dimension(const string& dimname, size_t value) {
     }
 }
 
+void NCFile::compress_variable(const string& varname, const std::vector<size_t>& chunks) {
+    if (!_netcdf4) {
+        return;
+    }
+    auto var = variable(varname);
+    try {
+        auto chunk_sizes = chunks;
+        var.setChunking(NcVar::nc_CHUNKED, chunk_sizes);
+        // The shuffle filter groups the bytes of the floats by significance,
+        // which makes them a lot more compressible. Higher deflate levels
+        // are much slower for very little gain with floating point data.
+        var.setCompression(true, true, 1);
+    } catch (const netCDF::exceptions::NcException& e) {
+        throw FileError("Can not compress variable \"" + varname + "\".\n" + e.what());
+    }
+}
+
 bool NCFile::is_open() {
     return (not file.isNull());
 }
 
+void NCFile::end_definitions() {
+    int status = nc_enddef(file.getId());
+    if (status != NC_NOERR && status != NC_ENOTINDEFINE) {
+        throw FileError("Could not write the header of the file " + filename() + ".\n" + nc_strerror(status));
+    }
+}
+
 void NCFile::sync() {
-    int res = nc_enddef(file.getId());
-    assert(res == NC_NOERR && "Got a bad NetCDF id.");
-    res = nc_sync(file.getId());
-    assert(res == NC_NOERR && "Got a bad NetCDF id.");
-    if (mode() == "a" || mode() == "w") {
-        res = nc_redef(file.getId());
-        assert(res == NC_NOERR && "Error in nc_redef!");
+    // Only flush the data, the file stays in data mode afterward. Going back
+    // to define mode would rewrite the header on the next write.
+    end_definitions();
+    int status = nc_sync(file.getId());
+    if (status != NC_NOERR) {
+        throw FileError("Could not sync the file " + filename() + ".\n" + nc_strerror(status));
     }
 }
 
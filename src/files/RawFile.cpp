@@ -0,0 +1,150 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <cstring>
+#include <cerrno>
+
+#include "chemfiles/files/RawFile.hpp"
+#include "chemfiles/Error.hpp"
+#include "chemfiles/config.hpp"
+
+#ifdef CHFL_WINDOWS
+    #include <io.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using namespace chemfiles;
+
+// Seek to a 64-bit offset in a C file
+static int seek64(std::FILE* file, uint64_t offset) {
+#ifdef CHFL_WINDOWS
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+// Get the size of an opened C file
+static uint64_t file_size(std::FILE* file) {
+#ifdef CHFL_WINDOWS
+    _fseeki64(file, 0, SEEK_END);
+    return static_cast<uint64_t>(_ftelli64(file));
+#else
+    struct stat info;
+    if (fstat(fileno(file), &info) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(info.st_size);
+#endif
+}
+
+RawFile::RawFile(const std::string& filename, const std::string& mode)
+: BinaryFile(filename, mode), _file(nullptr), _map(nullptr), _size(0), _position(0), _writing(false) {
+    if (mode == "r") {
+        _file = std::fopen(filename.c_str(), "rb");
+    } else if (mode == "a") {
+        // Open the file for reading and writing, creating it if needed
+        _file = std::fopen(filename.c_str(), "r+b");
+        if (_file == nullptr && errno == ENOENT) {
+            _file = std::fopen(filename.c_str(), "w+b");
+        }
+    } else if (mode == "w") {
+        _file = std::fopen(filename.c_str(), "w+b");
+    } else {
+        throw FileError("Unrecognized file mode: " + mode);
+    }
+
+    if (_file == nullptr) {
+        throw FileError("Could not open the file " + filename + ": " + std::strerror(errno));
+    }
+
+    _size = file_size(_file);
+    seek64(_file, 0);
+
+#ifndef CHFL_WINDOWS
+    if (mode == "r" && _size != 0) {
+        auto map = mmap(nullptr, static_cast<size_t>(_size), PROT_READ, MAP_SHARED, fileno(_file), 0);
+        if (map != MAP_FAILED) {
+            _map = static_cast<char*>(map);
+        }
+        // Fall back to the standard library if mmap failed
+    }
+#endif
+}
+
+RawFile::~RawFile() {
+#ifndef CHFL_WINDOWS
+    if (_map != nullptr) {
+        munmap(_map, static_cast<size_t>(_size));
+    }
+#endif
+    std::fclose(_file);
+}
+
+void RawFile::seek(uint64_t offset, bool writing) {
+    // The C standard requires a call to fseek when switching between reading
+    // and writing
+    if (offset != _position || writing != _writing) {
+        if (seek64(_file, offset) != 0) {
+            throw FileError("Could not seek in the file " + filename() + ": " + std::strerror(errno));
+        }
+        _position = offset;
+        _writing = writing;
+    }
+}
+
+const char* RawFile::read(uint64_t offset, size_t count) {
+    if (offset + count > _size) {
+        throw FileError(
+            "Can not read " + std::to_string(count) + " bytes at offset " +
+            std::to_string(offset) + " in the file " + filename() + ": the file is too small."
+        );
+    }
+
+    if (counters()) {
+        counters()->bytes_read += count;
+    }
+    if (_map != nullptr) {
+        return _map + offset;
+    }
+
+    CounterTimer timer(counters(), &Counters::file_time);
+    _buffer.resize(count);
+    seek(offset, false);
+    if (std::fread(_buffer.data(), 1, count, _file) != count) {
+        // The cursor position is unknown, force a seek on next access
+        _position = static_cast<uint64_t>(-1);
+        throw FileError("Could not read the file " + filename() + ".");
+    }
+    _position += count;
+    return _buffer.data();
+}
+
+void RawFile::write(uint64_t offset, const void* data, size_t count) {
+    if (mode() == "r") {
+        throw FileError("The file " + filename() + " was not opened in write or append mode.");
+    }
+    seek(offset, true);
+    if (std::fwrite(data, 1, count, _file) != count) {
+        _position = static_cast<uint64_t>(-1);
+        throw FileError("Could not write to the file " + filename() + ": " + std::strerror(errno));
+    }
+    _position += count;
+    if (_position > _size) {
+        _size = _position;
+    }
+}
+
+bool RawFile::is_open() {
+    return _file != nullptr;
+}
+
+void RawFile::sync() {
+    std::fflush(_file);
+}
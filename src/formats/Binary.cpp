@@ -0,0 +1,553 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <algorithm>
+#include <cstring>
+
+#include "chemfiles/formats/Binary.hpp"
+
+#include "chemfiles/Codec.hpp"
+#include "chemfiles/Error.hpp"
+#include "chemfiles/Logger.hpp"
+#include "chemfiles/Frame.hpp"
+#include "chemfiles/files/RawFile.hpp"
+using namespace chemfiles;
+
+// Magic number at the start of all the files
+static const char MAGIC[8] = {'C', 'H', 'F', 'L', 'B', 'I', 'N', '\0'};
+// Version of the format
+static const uint32_t VERSION = 1;
+// Size of the header in bytes
+static const uint64_t HEADER_SIZE = 64;
+// Size of the fixed part of a frame: frame size, step, cell type, flags and
+// the six cell parameters.
+static const uint64_t FRAME_HEADER_SIZE = 72;
+// Flag for files and frames with velocities
+static const uint32_t HAS_VELOCITIES = 1;
+// Flag for files with compressed frames
+static const uint32_t COMPRESSED = 2;
+// Flag for compressed frames which do not depend on the previous frames
+static const uint32_t KEYFRAME = 2;
+// Maximal number of compressed frames between two keyframes
+static const size_t KEYFRAME_INTERVAL = 32;
+
+static bool is_little_endian() {
+    const uint16_t value = 1;
+    char first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+// Encode \c value in little-endian order at \c output
+template <typename T>
+static void encode(char* output, T value) {
+    std::memcpy(output, &value, sizeof(T));
+    if (!is_little_endian()) {
+        std::reverse(output, output + sizeof(T));
+    }
+}
+
+// Decode a little-endian value from \c input
+template <typename T>
+static T decode(const char* input) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, input, sizeof(T));
+    if (!is_little_endian()) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+// Append the little-endian encoding of \c value to \c buffer
+template <typename T>
+static void append(std::vector<char>& buffer, T value) {
+    buffer.resize(buffer.size() + sizeof(T));
+    encode(&buffer[buffer.size() - sizeof(T)], value);
+}
+
+// Copy \c count floats in little-endian order from \c input to \c output
+static void copy_floats(char* output, const char* input, size_t count) {
+    std::memcpy(output, input, count * sizeof(float));
+    if (!is_little_endian()) {
+        for (size_t i=0; i<count; i++) {
+            std::reverse(output + i * sizeof(float), output + (i + 1) * sizeof(float));
+        }
+    }
+}
+
+// Cursor reading values from a memory region, checking for overflows
+class Decoder {
+public:
+    Decoder(const char* data, uint64_t size): data_(data), remaining_(size) {}
+
+    template <typename T>
+    T next() {
+        check(sizeof(T));
+        auto value = decode<T>(data_);
+        data_ += sizeof(T);
+        remaining_ -= sizeof(T);
+        return value;
+    }
+
+    std::string string(uint32_t size) {
+        check(size);
+        auto value = std::string(data_, size);
+        data_ += size;
+        remaining_ -= size;
+        return value;
+    }
+private:
+    void check(uint64_t size) {
+        if (size > remaining_) {
+            throw FormatError("Corrupted topology in chemfiles binary file.");
+        }
+    }
+
+    const char* data_;
+    uint64_t remaining_;
+};
+
+std::string BinaryFormat::description() const {
+    return "Chemfiles binary file format.";
+}
+
+bool BinaryFormat::sniff(const std::string& header) {
+    return header.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+BinaryFormat::BinaryFormat(File& file)
+: Format(file), rawfile(static_cast<RawFile&>(file)), step(0), natoms(0), velocities(false),
+  initialized(false), writing(false), data_offset(HEADER_SIZE), precision(0), end_offset(HEADER_SIZE),
+  since_keyframe(KEYFRAME_INTERVAL), decoded(static_cast<size_t>(-1)) {
+    if ((rawfile.mode() == "r" || rawfile.mode() == "a") && rawfile.size() != 0) {
+        read_header();
+    }
+}
+
+BinaryFormat::~BinaryFormat() {
+    if (rawfile.mode() == "r") {
+        return;
+    }
+    try {
+        if (!initialized) {
+            // Create a valid empty file
+            initialize(Frame());
+        }
+        finalize();
+    } catch (const Error& e) {
+        LOG(ERROR) << "Error while closing the file " << rawfile.filename() << ": " << e.what() << std::endl;
+    }
+}
+
+void BinaryFormat::read_header() {
+    auto header = rawfile.read(0, HEADER_SIZE);
+    if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        throw FormatError("The file " + rawfile.filename() + " is not a chemfiles binary file.");
+    }
+    auto version = decode<uint32_t>(header + 8);
+    if (version != VERSION) {
+        throw FormatError(
+            "Unsupported version " + std::to_string(version) + " of the chemfiles binary format in " +
+            rawfile.filename() + ". Only version " + std::to_string(VERSION) + " is supported."
+        );
+    }
+    auto flags = decode<uint32_t>(header + 12);
+    velocities = (flags & HAS_VELOCITIES) != 0;
+    natoms = static_cast<size_t>(decode<uint64_t>(header + 16));
+    auto topology_size = decode<uint64_t>(header + 24);
+    auto nframes = decode<uint64_t>(header + 32);
+    auto index_offset = decode<uint64_t>(header + 40);
+    if (flags & COMPRESSED) {
+        precision = decode<double>(header + 48);
+        if (!(precision > 0)) {
+            throw FormatError("Invalid compression precision in chemfiles binary file " + rawfile.filename() + ".");
+        }
+    }
+    data_offset = HEADER_SIZE + topology_size;
+    initialized = true;
+
+    auto decoder = Decoder(rawfile.read(HEADER_SIZE, static_cast<size_t>(topology_size)), topology_size);
+    auto new_topology = std::make_shared<Topology>();
+    new_topology->reserve(natoms);
+    for (size_t i=0; i<natoms; i++) {
+        auto name = decoder.string(decoder.next<uint32_t>());
+        auto type = decoder.next<uint32_t>();
+        if (type > Atom::UNDEFINED) {
+            throw FormatError("Corrupted topology in chemfiles binary file.");
+        }
+        Atom atom(static_cast<Atom::AtomType>(type), name);
+        atom.mass(decoder.next<float>());
+        atom.charge(decoder.next<float>());
+        new_topology->append(atom);
+    }
+    auto nbonds = decoder.next<uint64_t>();
+    for (uint64_t i=0; i<nbonds; i++) {
+        auto atom_i = decoder.next<uint64_t>();
+        auto atom_j = decoder.next<uint64_t>();
+        if (atom_i >= natoms || atom_j >= natoms) {
+            throw FormatError("Corrupted topology in chemfiles binary file.");
+        }
+        new_topology->add_bond(static_cast<size_t>(atom_i), static_cast<size_t>(atom_j));
+    }
+    new_topology->recalculate();
+    topology = new_topology;
+
+    // Use the index if it was written (the offset is 0 otherwise), and if it
+    // fits in the file
+    if (index_offset >= data_offset && index_offset + 8 * nframes <= rawfile.size()) {
+        auto index = rawfile.read(index_offset, static_cast<size_t>(8 * nframes));
+        offsets.resize(static_cast<size_t>(nframes));
+        for (size_t i=0; i<offsets.size(); i++) {
+            offsets[i] = decode<uint64_t>(index + 8 * i);
+        }
+        // The index is written right after the last frame
+        end_offset = index_offset;
+    } else {
+        LOG(WARNING) << "Missing frames index in " << rawfile.filename() << ", the file is still "
+                     << "open or was not closed properly. Looking for the frames in the file." << std::endl;
+        recover();
+    }
+}
+
+void BinaryFormat::recover() {
+    offsets.clear();
+    auto offset = data_offset;
+    while (offset + FRAME_HEADER_SIZE <= rawfile.size()) {
+        auto header = rawfile.read(offset, FRAME_HEADER_SIZE);
+        auto size = decode<uint64_t>(header);
+        auto cell_type = decode<uint32_t>(header + 16);
+        bool valid_size = precision == 0 ? size == frame_size() : size >= FRAME_HEADER_SIZE;
+        if (!valid_size || size > rawfile.size() - offset || cell_type > UnitCell::INFINITE) {
+            break; // This is not a complete frame
+        }
+        offsets.push_back(offset);
+        offset += size;
+    }
+    end_offset = offset;
+}
+
+uint64_t BinaryFormat::frame_size() const {
+    uint64_t arrays = velocities ? 2 : 1;
+    return FRAME_HEADER_SIZE + arrays * 3 * sizeof(float) * natoms;
+}
+
+size_t BinaryFormat::nsteps() const {
+    return offsets.size();
+}
+
+bool BinaryFormat::random_access() const {
+    // Compressed frames only need to decode the frames since the last keyframe
+    return true;
+}
+
+void BinaryFormat::read_step(const size_t _step, Frame& frame) {
+    if (_step >= offsets.size()) {
+        throw FormatError(
+            "Can not read step " + std::to_string(_step) + " in the file " +
+            rawfile.filename() + " with " + std::to_string(offsets.size()) + " steps."
+        );
+    }
+    if (precision != 0) {
+        decode_until(_step);
+    }
+    uint64_t size = 0;
+    auto data = read_record(_step, size);
+
+    frame.step(static_cast<size_t>(decode<uint64_t>(data + 8)));
+    auto cell_type = decode<uint32_t>(data + 16);
+    auto flags = decode<uint32_t>(data + 20);
+    if (cell_type == UnitCell::INFINITE) {
+        frame.cell(UnitCell());
+    } else if (cell_type == UnitCell::ORTHOROMBIC || cell_type == UnitCell::TRICLINIC) {
+        auto cell = UnitCell(
+            decode<double>(data + 24), decode<double>(data + 32), decode<double>(data + 40),
+            decode<double>(data + 48), decode<double>(data + 56), decode<double>(data + 64)
+        );
+        cell.type(static_cast<UnitCell::CellType>(cell_type));
+        frame.cell(cell);
+    } else {
+        throw FormatError("Corrupted unit cell at step " + std::to_string(_step) + " in " + rawfile.filename() + ".");
+    }
+
+    auto has_velocities = velocities && (flags & HAS_VELOCITIES) != 0;
+    frame.resize(natoms, has_velocities);
+    if (!has_velocities) {
+        frame.velocities().clear();
+    }
+    frame.topology(topology);
+
+    if (precision != 0) {
+        auto& frame_velocities = has_velocities ? frame.velocities() : scratch[1];
+        decode_record(data, size, frame.positions(), frame_velocities);
+        decoded = _step;
+    } else if (natoms != 0) {
+        auto positions = data + FRAME_HEADER_SIZE;
+        copy_floats(reinterpret_cast<char*>(frame.positions()[0].data()), positions, 3 * natoms);
+        if (has_velocities) {
+            auto frame_velocities = positions + 3 * sizeof(float) * natoms;
+            copy_floats(reinterpret_cast<char*>(frame.velocities()[0].data()), frame_velocities, 3 * natoms);
+        }
+    }
+    // The next sequential read continues after this step
+    step = _step + 1;
+}
+
+const char* BinaryFormat::read_record(size_t _step, uint64_t& size) {
+    auto offset = offsets[_step];
+    size = decode<uint64_t>(rawfile.read(offset, 8));
+    bool valid_size = precision == 0 ? size == frame_size() : size >= FRAME_HEADER_SIZE;
+    if (!valid_size || size > rawfile.size() - offset) {
+        throw FormatError("Corrupted frame at step " + std::to_string(_step) + " in " + rawfile.filename() + ".");
+    }
+    return rawfile.read(offset, static_cast<size_t>(size));
+}
+
+void BinaryFormat::decode_record(const char* data, uint64_t size, Array3D& positions, Array3D& frame_velocities) {
+    if (!decoders[0]) {
+        decoders[0].reset(new LossyCodec(precision));
+        decoders[1].reset(new LossyCodec(precision));
+    }
+    auto keyframe = (decode<uint32_t>(data + 20) & KEYFRAME) != 0;
+    uint64_t offset = FRAME_HEADER_SIZE;
+    size_t narrays = velocities ? 2 : 1;
+    for (size_t i=0; i<narrays; i++) {
+        auto& array = i == 0 ? positions : frame_velocities;
+        if (size - offset < 8 || decode<uint64_t>(data + offset) > size - offset - 8) {
+            throw FormatError("Corrupted compressed frame in " + rawfile.filename() + ".");
+        }
+        auto length = decode<uint64_t>(data + offset);
+        decoders[i]->decode(data + offset + 8, static_cast<size_t>(length), keyframe, array);
+        if (array.size() != natoms) {
+            throw FormatError("Corrupted compressed frame in " + rawfile.filename() + ".");
+        }
+        offset += 8 + length;
+    }
+}
+
+void BinaryFormat::decode_until(size_t _step) {
+    // Reuse the state of the decoders if they decoded a frame before this
+    // step, which is always the case when reading sequentially.
+    size_t first = 0;
+    if (decoded != static_cast<size_t>(-1) && decoded < _step) {
+        first = decoded + 1;
+    }
+    // Look for a keyframe between the first usable frame and this step
+    auto start = _step;
+    while (start > first) {
+        uint64_t size = 0;
+        auto data = read_record(start, size);
+        if (decode<uint32_t>(data + 20) & KEYFRAME) {
+            break;
+        }
+        start--;
+    }
+
+    decoded = static_cast<size_t>(-1);
+    for (auto i=start; i<_step; i++) {
+        uint64_t size = 0;
+        auto data = read_record(i, size);
+        decode_record(data, size, scratch[0], scratch[1]);
+    }
+}
+
+void BinaryFormat::read(Frame& frame) {
+    read_step(step, frame);
+}
+
+void BinaryFormat::initialize(const Frame& frame) {
+    natoms = frame.natoms();
+    velocities = frame.has_velocities();
+
+    const auto& frame_topology = frame.topology();
+    auto topology_natoms = std::min(frame_topology.natoms(), natoms);
+    if (frame_topology.natom_types() == 0) {
+        // Topology created with a size, but without any atom
+        topology_natoms = 0;
+    }
+    buffer.clear();
+    for (size_t i=0; i<topology_natoms; i++) {
+        const auto& atom = frame_topology[i];
+        append<uint32_t>(buffer, static_cast<uint32_t>(atom.name().size()));
+        buffer.insert(buffer.end(), atom.name().begin(), atom.name().end());
+        append<uint32_t>(buffer, static_cast<uint32_t>(atom.type()));
+        append<float>(buffer, atom.mass());
+        append<float>(buffer, atom.charge());
+    }
+    // Frames without topology use undefined atoms
+    for (size_t i=topology_natoms; i<natoms; i++) {
+        append<uint32_t>(buffer, 0);
+        append<uint32_t>(buffer, static_cast<uint32_t>(Atom::UNDEFINED));
+        append<float>(buffer, 0);
+        append<float>(buffer, 0);
+    }
+
+    auto bonds = frame_topology.bonds();
+    bonds.erase(std::remove_if(bonds.begin(), bonds.end(), [this](const bond& b){
+        return b[0] >= natoms || b[1] >= natoms;
+    }), bonds.end());
+    append<uint64_t>(buffer, bonds.size());
+    for (auto& bond: bonds) {
+        append<uint64_t>(buffer, bond[0]);
+        append<uint64_t>(buffer, bond[1]);
+    }
+
+    data_offset = HEADER_SIZE + buffer.size();
+    end_offset = data_offset;
+    rawfile.write(HEADER_SIZE, buffer.data(), buffer.size());
+    write_header(0);
+    initialized = true;
+    writing = true;
+}
+
+void BinaryFormat::write_header(uint64_t index_offset) {
+    char header[HEADER_SIZE] = {0};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    encode<uint32_t>(header + 8, VERSION);
+    uint32_t flags = velocities ? HAS_VELOCITIES : 0;
+    if (precision != 0) {
+        flags |= COMPRESSED;
+    }
+    encode<uint32_t>(header + 12, flags);
+    encode<uint64_t>(header + 16, natoms);
+    encode<uint64_t>(header + 24, data_offset - HEADER_SIZE);
+    encode<uint64_t>(header + 32, offsets.size());
+    encode<uint64_t>(header + 40, index_offset);
+    encode<double>(header + 48, precision);
+    rawfile.write(0, header, HEADER_SIZE);
+}
+
+void BinaryFormat::write(const Frame& frame) {
+    if (!initialized) {
+        initialize(frame);
+    } else if (!writing) {
+        // The index at the end of the file will be overwritten by the new
+        // frames, mark it as invalid until the file is closed.
+        write_header(0);
+        writing = true;
+    }
+
+    if (frame.natoms() != natoms) {
+        throw FormatError(
+            "Can not write a frame with " + std::to_string(frame.natoms()) +
+            " atoms to a chemfiles binary file with " + std::to_string(natoms) + " atoms."
+        );
+    }
+
+    auto offset = end_offset;
+    auto has_velocities = velocities && frame.has_velocities();
+    auto keyframe = since_keyframe >= KEYFRAME_INTERVAL;
+
+    char header[FRAME_HEADER_SIZE];
+    encode<uint64_t>(header, frame_size());
+    encode<uint64_t>(header + 8, frame.step());
+    const auto& cell = frame.cell();
+    encode<uint32_t>(header + 16, static_cast<uint32_t>(cell.type()));
+    uint32_t flags = has_velocities ? HAS_VELOCITIES : 0;
+    if (precision != 0 && keyframe) {
+        flags |= KEYFRAME;
+    }
+    encode<uint32_t>(header + 20, flags);
+    encode<double>(header + 24, cell.a());
+    encode<double>(header + 32, cell.b());
+    encode<double>(header + 40, cell.c());
+    encode<double>(header + 48, cell.alpha());
+    encode<double>(header + 56, cell.beta());
+    encode<double>(header + 64, cell.gamma());
+
+    if (precision != 0) {
+        buffer.assign(header, header + FRAME_HEADER_SIZE);
+        write_compressed(frame, keyframe);
+        encode<uint64_t>(buffer.data(), buffer.size());
+        rawfile.write(offset, buffer.data(), buffer.size());
+        end_offset += buffer.size();
+    } else {
+        rawfile.write(offset, header, FRAME_HEADER_SIZE);
+        auto bytes = 3 * sizeof(float) * natoms;
+        if (natoms != 0) {
+            write_array(offset + FRAME_HEADER_SIZE, frame.positions());
+            if (has_velocities) {
+                write_array(offset + FRAME_HEADER_SIZE + bytes, frame.velocities());
+            } else if (velocities) {
+                // Keep the same size for all the frames
+                buffer.assign(bytes, 0);
+                rawfile.write(offset + FRAME_HEADER_SIZE + bytes, buffer.data(), bytes);
+            }
+        }
+        end_offset += frame_size();
+    }
+    offsets.push_back(offset);
+}
+
+void BinaryFormat::write_compressed(const Frame& frame, bool keyframe) {
+    if (!encoders[0]) {
+        encoders[0].reset(new LossyCodec(precision));
+        encoders[1].reset(new LossyCodec(precision));
+    }
+
+    size_t narrays = velocities ? 2 : 1;
+    try {
+        for (size_t i=0; i<narrays; i++) {
+            const Array3D* array = &frame.positions();
+            if (i == 1) {
+                if (frame.has_velocities()) {
+                    array = &frame.velocities();
+                } else {
+                    // Frames without velocities use zeros
+                    scratch[1].assign(natoms, Vector3D());
+                    array = &scratch[1];
+                }
+            }
+            auto length_offset = buffer.size();
+            append<uint64_t>(buffer, 0);
+            encoders[i]->encode(*array, keyframe, buffer);
+            encode<uint64_t>(buffer.data() + length_offset, buffer.size() - length_offset - 8);
+        }
+    } catch (const Error&) {
+        // The encoders state is not consistent anymore, the next frame will
+        // need to be a keyframe.
+        since_keyframe = KEYFRAME_INTERVAL;
+        throw;
+    }
+    since_keyframe = keyframe ? 1 : since_keyframe + 1;
+}
+
+void BinaryFormat::option(const std::string& name, double value) {
+    if (name != "precision") {
+        Format::option(name, value);
+        return;
+    }
+    if (initialized) {
+        throw FormatError("The precision of a chemfiles binary file can only be set before writing the first frame.");
+    }
+    precision = value > 0 ? value : 0;
+}
+
+void BinaryFormat::write_array(uint64_t offset, const Array3D& array) {
+    auto data = reinterpret_cast<const char*>(array[0].data());
+    auto bytes = 3 * sizeof(float) * natoms;
+    if (is_little_endian()) {
+        // Write directly from the array memory
+        rawfile.write(offset, data, bytes);
+    } else {
+        buffer.resize(bytes);
+        copy_floats(buffer.data(), data, 3 * natoms);
+        rawfile.write(offset, buffer.data(), bytes);
+    }
+}
+
+void BinaryFormat::finalize() {
+    auto index_offset = end_offset;
+    buffer.clear();
+    for (auto offset: offsets) {
+        append<uint64_t>(buffer, offset);
+    }
+    rawfile.write(index_offset, buffer.data(), buffer.size());
+    write_header(index_offset);
+    rawfile.sync();
+}
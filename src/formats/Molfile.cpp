@@ -6,6 +6,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/
 */
 #include <map>
+#include <cstdint>
 #include <cstdlib>
 
 #include "chemfiles/formats/Molfile.hpp"
@@ -207,14 +208,17 @@ void Molfile<F>::read_topology() const {
         throw PluginError("Error while reading atomic names.");
     }
 
-    _topology = Topology();
+    // Frames read before this call keep sharing the previous topology
+    auto topology = std::make_shared<Topology>();
+    _topology = topology;
+    topology->reserve(atoms.size());
 
     for (auto& vmd_atom : atoms){
         Atom atom(vmd_atom.name);
         if (optflags & MOLFILE_MASS){
             atom.mass(vmd_atom.mass);
         }
-        _topology.append(atom);
+        topology->append(atom);
     }
 
     if (_plugin->read_bonds == NULL)
@@ -237,10 +241,10 @@ void Molfile<F>::read_topology() const {
 
     for (size_t i=0; i<static_cast<size_t>(nbonds); i++){
         // Indexes are 1-based in Molfile
-        _topology.add_bond(static_cast<size_t>(from[i] - 1),
+        topology->add_bond(static_cast<size_t>(from[i] - 1),
                            static_cast<size_t>(to[i]) - 1);
     }
-    _topology.recalculate();
+    topology->recalculate();
 }
 
 template <MolfileFormat F> const char* Molfile<F>::name() {
@@ -253,6 +257,86 @@ template <MolfileFormat F> const char* Molfile<F>::extension() {
     return val;
 }
 
+// Decode a big-endian 32-bit integer at the start of \c data
+static uint32_t big_endian(const std::string& data) {
+    uint32_t value = 0;
+    for (size_t i=0; i<4; i++) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+// Get the line at \c index in \c header, or an empty string if this line is
+// not complete.
+static std::string complete_line(const std::string& header, size_t index) {
+    size_t start = 0;
+    for (size_t i=0; i<index; i++) {
+        start = header.find('\n', start);
+        if (start == std::string::npos) {
+            return "";
+        }
+        start++;
+    }
+    auto end = header.find('\n', start);
+    if (end == std::string::npos) {
+        return "";
+    }
+    return header.substr(start, end - start);
+}
+
+template <MolfileFormat F> bool Molfile<F>::sniff(const std::string&) {
+    return false;
+}
+
+namespace chemfiles {
+
+template <> bool Molfile<PDB>::sniff(const std::string& header) {
+    static const char* RECORDS[] = {
+        "HEADER", "TITLE ", "COMPND", "REMARK", "CRYST1", "MODEL ", "ATOM  ", "HETATM"
+    };
+    auto record = header.substr(0, 6);
+    record.resize(6, ' ');
+    for (auto expected: RECORDS) {
+        if (record == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <> bool Molfile<DCD>::sniff(const std::string& header) {
+    // Fortran record of 84 bytes, in any endianness, starting with "CORD"
+    if (header.size() < 8) {
+        return false;
+    }
+    auto size = header.substr(0, 4);
+    auto little = std::string("\x54\0\0\0", 4);
+    auto big = std::string("\0\0\0\x54", 4);
+    return (size == little || size == big) && header.compare(4, 4, "CORD") == 0;
+}
+
+template <> bool Molfile<GRO>::sniff(const std::string& header) {
+    // A title line, the number of atoms and fixed-width atomic lines
+    auto natoms = complete_line(header, 1);
+    auto first = natoms.find_first_not_of(" \t");
+    auto last = natoms.find_last_not_of(" \t\r");
+    if (first == std::string::npos || natoms.find_first_not_of("0123456789", first) <= last) {
+        return false;
+    }
+    auto atom = complete_line(header, 2);
+    return atom.empty() || atom.size() >= 44;
+}
+
+template <> bool Molfile<TRR>::sniff(const std::string& header) {
+    return header.size() >= 4 && big_endian(header) == 1993;
+}
+
+template <> bool Molfile<XTC>::sniff(const std::string& header) {
+    return header.size() >= 4 && big_endian(header) == 1995;
+}
+
+} // namespace chemfiles
+
 /******************************************************************************/
 
 // Instanciate the templates
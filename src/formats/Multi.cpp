@@ -0,0 +1,177 @@
+/* Chemfiles, an efficient IO library for chemistry file formats
+ * Copyright (C) 2015 Guillaume Fraux
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/
+*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "chemfiles/formats/Multi.hpp"
+
+#include "chemfiles/Error.hpp"
+#include "chemfiles/Frame.hpp"
+#include "chemfiles/files/MultiFile.hpp"
+using namespace chemfiles;
+
+// Default maximal number of files open at the same time
+static const size_t DEFAULT_MAX_OPEN_FILES = 16;
+
+std::string MultiFormat::description() const {
+    return "Multiple files read as a single trajectory.";
+}
+
+MultiFormat::MultiFormat(File& f)
+: Format(f), multifile(static_cast<MultiFile&>(f)), max_open_files(DEFAULT_MAX_OPEN_FILES), step(0) {
+    auto& paths = multifile.paths();
+    builders.reserve(paths.size());
+    for (auto& path: paths) {
+        if (multifile.format().empty()) {
+            builders.push_back(TrajectoryFactory::get().guess(path, "r"));
+        } else {
+            builders.push_back(TrajectoryFactory::get().format(multifile.format()));
+        }
+    }
+    files.resize(paths.size());
+    count_steps();
+}
+
+MultiFormat::~MultiFormat() {
+    close_files(0);
+}
+
+void MultiFormat::count_steps() {
+    auto& paths = multifile.paths();
+    std::vector<size_t> counts(paths.size(), 0);
+    auto count = [&](size_t i) {
+        auto file = builders[i].file_creator(paths[i], "r");
+        auto format = builders[i].format_creator(*file);
+        counts[i] = format->nsteps();
+    };
+
+    auto thread_safe = std::all_of(builders.begin(), builders.end(), [](const trajectory_builder_t& builder){
+        return builder.thread_safe;
+    });
+    size_t nthreads = 1;
+    if (thread_safe) {
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+        nthreads = std::min({nthreads, paths.size(), max_open_files});
+    }
+
+    if (nthreads <= 1) {
+        for (size_t i=0; i<paths.size(); i++) {
+            count(i);
+        }
+    } else {
+        // Each thread takes the next file to count until all files are done,
+        // and the first error is sent back to the calling thread.
+        std::atomic<size_t> next(0);
+        std::mutex mutex;
+        std::exception_ptr error;
+        std::vector<std::thread> threads;
+        for (size_t i=0; i<nthreads; i++) {
+            threads.emplace_back([&](){
+                size_t index;
+                while ((index = next++) < paths.size()) {
+                    try {
+                        count(index);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        next = paths.size();
+                    }
+                }
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    first_steps.resize(paths.size() + 1);
+    first_steps[0] = 0;
+    for (size_t i=0; i<paths.size(); i++) {
+        first_steps[i + 1] = first_steps[i] + counts[i];
+    }
+}
+
+size_t MultiFormat::nsteps() const {
+    return first_steps.back();
+}
+
+Format& MultiFormat::open(size_t index) {
+    auto& opened = files[index];
+    if (opened.format) {
+        recently_used.remove(index);
+    } else {
+        close_files(max_open_files - 1);
+        auto& path = multifile.paths()[index];
+        opened.file = builders[index].file_creator(path, "r");
+        opened.format = builders[index].format_creator(*opened.file);
+        opened.next = 0;
+    }
+    // The counters may have been enabled since the file was opened
+    opened.file->counters(multifile.counters());
+    recently_used.push_front(index);
+    return *opened.format;
+}
+
+void MultiFormat::close_files(size_t max) {
+    while (recently_used.size() > max) {
+        auto& opened = files[recently_used.back()];
+        // The format may use the file in its destructor
+        opened.format.reset();
+        opened.file.reset();
+        recently_used.pop_back();
+    }
+}
+
+void MultiFormat::read_step(const size_t _step, Frame& frame) {
+    if (_step >= nsteps()) {
+        throw FormatError(
+            "Can not read step " + std::to_string(_step) + " in " + multifile.filename() +
+            " with " + std::to_string(nsteps()) + " steps."
+        );
+    }
+    // Find the last file starting before this step. Empty files start at the
+    // same step as the next one, and are skipped.
+    auto it = std::upper_bound(first_steps.begin(), first_steps.end(), _step);
+    auto index = static_cast<size_t>(it - first_steps.begin()) - 1;
+    auto local = _step - first_steps[index];
+
+    auto& format = open(index);
+    auto& opened = files[index];
+    if (opened.next == local) {
+        format.read(frame);
+    } else {
+        format.read_step(local, frame);
+    }
+    opened.next = local + 1;
+    step = _step + 1;
+}
+
+void MultiFormat::read(Frame& frame) {
+    read_step(step, frame);
+}
+
+void MultiFormat::option(const std::string& name, double value) {
+    if (name != "max_open_files") {
+        Format::option(name, value);
+        return;
+    }
+    if (!(value >= 1) || std::floor(value) != value) {
+        throw FormatError("The maximal number of open files must be a positive integer, got " + std::to_string(value) + ".");
+    }
+    max_open_files = static_cast<size_t>(value);
+    close_files(max_open_files);
+}
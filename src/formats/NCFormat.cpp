@@ -27,6 +27,21 @@ std::string NCFormat::description() const {
     return "Amber NetCDF file format.";
 }
 
+bool NCFormat::sniff(const std::string& header) {
+    // Classic, 64-bit offset and 64-bit data NetCDF 3 files
+    for (auto version: {'\x01', '\x02', '\x05'}) {
+        if (header.compare(0, 4, std::string("CDF") + version) == 0) {
+            return true;
+        }
+    }
+    // NetCDF 4 files are HDF5 files
+    return header.compare(0, 8, "\x89HDF\r\n\x1a\n") == 0;
+}
+
+std::string NC4Format::description() const {
+    return "Amber NetCDF file format, using compressed NetCDF 4 files.";
+}
+
 //! Check the validity of a NetCDF file
 static bool is_valid(const NCFile& ncfile, size_t natoms){
     bool writing;
@@ -65,12 +80,36 @@ static bool is_valid(const NCFile& ncfile, size_t natoms){
     return true;
 }
 
-NCFormat::NCFormat(File& file) : Format(file), ncfile(static_cast<NCFile&>(file)), step(0), validated(false) {
+NCFormat::NCFormat(File& file)
+: Format(file), ncfile(static_cast<NCFile&>(file)), step(0), natoms(0), nselected(0), validated(false) {
     if (ncfile.mode() == "r" || ncfile.mode() == "a") {
         if (!is_valid(ncfile, static_cast<size_t>(-1))) {
             throw FormatError("Invalid AMBER NetCDF file " + file.filename());
         }
         validated = true;
+        setup();
+    }
+    if (ncfile.mode() == "a") {
+        // Write new frames after the existing ones
+        step = nsteps();
+    }
+}
+
+void NCFormat::setup() {
+    natoms = ncfile.dimension("atom");
+
+    if (ncfile.has_variable("coordinates")) {
+        coordinates = ncfile.variable("coordinates");
+    }
+    if (ncfile.has_variable("velocities")) {
+        velocities = ncfile.variable("velocities");
+    }
+
+    bool has_cell = ncfile.has_dimension("cell_spatial") && ncfile.has_dimension("cell_angular") &&
+                    ncfile.has_variable("cell_lengths") && ncfile.has_variable("cell_angles");
+    if (has_cell && ncfile.dimension("cell_spatial") == 3 && ncfile.dimension("cell_angular") == 3) {
+        cell_lengths = ncfile.variable("cell_lengths");
+        cell_angles = ncfile.variable("cell_angles");
     }
 }
 
@@ -78,40 +117,115 @@ size_t NCFormat::nsteps() const {
     return static_cast<size_t>(ncfile.dimension("frame"));
 }
 
-
 void NCFormat::read_step(const size_t _step, Frame& frame){
     // Set the internal step before further reading
     step = _step;
-    reserve(ncfile.dimension("atom"));
     frame.cell(read_cell());
-
-    auto& pos = frame.positions();
-    read_array3D(pos, "coordinates");
-    auto& vel = frame.velocities();
-    read_array3D(vel, "velocities");
+    read_array3D(frame.positions(), coordinates);
+    read_array3D(frame.velocities(), velocities);
+    // The next sequential read continues after this step
+    step++;
 }
 
 void NCFormat::read(Frame& frame) {
     read_step(step, frame);
-    step++;
 }
 
-void NCFormat::reserve(size_t natoms) const{
-    cache = vector<float>(3*natoms);
-    std::fill(begin(cache), end(cache), 0);
+bool NCFormat::random_access() const {
+    return true;
 }
 
-UnitCell NCFormat::read_cell() const {
-    if (ncfile.dimension("cell_spatial") != 3 or ncfile.dimension("cell_angular") != 3)
-        return UnitCell(); // No UnitCell information
+// Maximal number of floats in the staging buffer used when reading multiple
+// frames at once. Keeping the buffer small (1 MiB) is faster than reading
+// more frames at once, as the data stays in the CPU cache.
+static const size_t MAX_CACHE_SIZE = 256 * 1024;
+
+void NCFormat::read_block(size_t first, size_t last, size_t stride, std::vector<Frame>& frames) {
+    auto nframes = (last - first + stride - 1) / stride;
+    frames.resize(nframes);
+
+    if (stride != 1 || !selected_runs.empty()) {
+        // Strided reads in NetCDF access the file value by value, which is a
+        // lot slower than reading each frame with a contiguous read. Reading
+        // a selection already uses one hyperslab per run of selected atoms.
+        for (size_t i=0; i<nframes; i++) {
+            read_step(first + i * stride, frames[i]);
+        }
+    } else {
+        // Read as many consecutive frames as possible with each call to
+        // NetCDF, as long as the staging buffer stays small enough.
+        auto chunk = std::max(MAX_CACHE_SIZE / std::max(3 * natoms, size_t(1)), size_t(1));
+        for (size_t done = 0; done < nframes; done += chunk) {
+            auto count = std::min(chunk, nframes - done);
+            read_cells(first + done, count, &frames[done]);
+            read_arrays3D(first + done, count, &frames[done], coordinates, &Frame::positions);
+            read_arrays3D(first + done, count, &frames[done], velocities, &Frame::velocities);
+        }
+    }
+    step = last;
+}
+
+void NCFormat::read_cells(size_t first, size_t count, Frame* frames) const {
+    if (cell_lengths.isNull() || cell_angles.isNull()) {
+        for (size_t i=0; i<count; i++) {
+            frames[i].cell(UnitCell());
+        }
+        return;
+    }
+
+    cache.resize(6 * count);
+    vector<size_t> start{first, 0};
+    vector<size_t> counts{count, 3};
+    cell_lengths.getVar(start, counts, cache.data());
+    cell_angles.getVar(start, counts, cache.data() + 3 * count);
+
+    for (size_t i=0; i<count; i++) {
+        auto length = &cache[3 * i];
+        auto angles = &cache[3 * (count + i)];
+        frames[i].cell(UnitCell(length[0], length[1], length[2], angles[0], angles[1], angles[2]));
+    }
+}
 
-    NcVar length_var;
-    NcVar angles_var;
-    try {
-        length_var = ncfile.variable("cell_lengths");
-        angles_var = ncfile.variable("cell_angles");
+void NCFormat::read_arrays3D(size_t first, size_t count, Frame* frames,
+                             const NcVar& var, Array3D& (Frame::*array)()) const {
+    if (count == 1) {
+        // No need for the staging buffer
+        auto old_step = step;
+        step = first;
+        read_array3D((frames[0].*array)(), var);
+        step = old_step;
+        return;
     }
-    catch (const FileError&) {
+
+    if (var.isNull()) {
+        // No information for this variable in the file, remove any data
+        // remaining in the reused frames
+        for (size_t i=0; i<count; i++) {
+            (frames[i].*array)().clear();
+        }
+        return;
+    }
+
+    for (size_t i=0; i<count; i++) {
+        (frames[i].*array)().resize(natoms);
+    }
+    if (natoms == 0) {
+        return;
+    }
+
+    cache.resize(count * natoms * 3);
+    vector<size_t> start{first, 0, 0};
+    vector<size_t> counts{count, natoms, 3};
+    var.getVar(start, counts, cache.data());
+
+    for (size_t i=0; i<count; i++) {
+        auto begin = cache.begin() + static_cast<ptrdiff_t>(3 * natoms * i);
+        std::copy(begin, begin + static_cast<ptrdiff_t>(3 * natoms), (frames[i].*array)()[0].data());
+    }
+}
+
+UnitCell NCFormat::read_cell() const {
+    if (cell_lengths.isNull() || cell_angles.isNull()) {
         return UnitCell(); // No UnitCell information
     }
 
@@ -121,38 +235,66 @@ UnitCell NCFormat::read_cell() const {
     vector<size_t> start{step, 0};
     vector<size_t> count{1, 3};
 
-    length_var.getVar(start, count, length);
-    angles_var.getVar(start, count, angles);
+    cell_lengths.getVar(start, count, length);
+    cell_angles.getVar(start, count, angles);
 
     return UnitCell(length[0], length[1], length[2], angles[0], angles[1], angles[2]);
 }
 
-void NCFormat::read_array3D(Array3D& arr, const string& name) const{
-    NcVar array_var;
-    try {
-        array_var = ncfile.variable(name);
+void NCFormat::read_array3D(Array3D& arr, const NcVar& var) const {
+    if (var.isNull()) {
+        arr.clear(); // No information for this variable in the file
+        return;
     }
-    catch (const FileError&) {
-        return; // No information for this variable in the file
+
+    if (!selected_runs.empty()) {
+        // Read each run of selected atoms with an hyperslab
+        arr.resize(nselected);
+        size_t offset = 0;
+        for (auto& run: selected_runs) {
+            vector<size_t> start{step, run.first, 0};
+            vector<size_t> count{1, run.second, 3};
+            var.getVar(start, count, arr[offset].data());
+            offset += run.second;
+        }
+        return;
     }
 
-    auto natoms = ncfile.dimension("atom");
+    arr.resize(natoms);
+    if (natoms == 0) {
+        return;
+    }
 
     vector<size_t> start{step, 0, 0};
     vector<size_t> count{1, natoms, 3};
-    array_var.getVar(start, count, cache.data());
+    // Read directly in the array memory, Vector3D has the same layout as float[3]
+    var.getVar(start, count, arr[0].data());
+}
 
-    arr = Array3D(natoms);
+bool NCFormat::selection(const std::vector<size_t>& atoms) {
+    if (!atoms.empty() && validated && atoms.back() >= natoms) {
+        throw Error(
+            "Can not select the atom " + std::to_string(atoms.back()) +
+            " in an Amber NetCDF file with " + std::to_string(natoms) + " atoms."
+        );
+    }
 
-    for (size_t i=0; i<natoms; i++) {
-        arr[i][0] = cache[3*i + 0];
-        arr[i][1] = cache[3*i + 1];
-        arr[i][2] = cache[3*i + 2];
+    selected_runs.clear();
+    nselected = atoms.size();
+    for (auto atom: atoms) {
+        if (!selected_runs.empty() && selected_runs.back().first + selected_runs.back().second == atom) {
+            selected_runs.back().second++;
+        } else {
+            selected_runs.emplace_back(atom, 1);
+        }
     }
+    return true;
 }
 
 // Initialize a file, assuming that it is empty
 static void initialize(NCFile& ncfile, size_t natoms, bool velocities){
+    // Define everything in the file before writing any data, so that the
+    // header is written only once
     ncfile.add_global_attribute("Conventions", "AMBER");
     ncfile.add_global_attribute("ConventionVersion", "1.0");
     ncfile.add_global_attribute("program", "Chemfiles");
@@ -166,68 +308,73 @@ static void initialize(NCFile& ncfile, size_t natoms, bool velocities){
     ncfile.add_dimension("label", 10);
 
     ncfile.add_variable<char>("spatial", "spatial");
-    auto spatial = ncfile.variable("spatial");
-    spatial.putVar("xyz");
-
     ncfile.add_variable<char>("cell_spatial", "cell_spatial");
-    auto cell_spatial = ncfile.variable("cell_spatial");
-    cell_spatial.putVar("abc");
-
     ncfile.add_variable<char>("cell_angular", "cell_angular", "label");
-    auto cell_angular = ncfile.variable("cell_angular");
-    const char angles[3][10]{"alpha", "beta", "gamma"};
-    cell_angular.putVar(angles);
+
+    // NetCDF 4 files store each frame in its own compressed chunk
+    auto atoms_chunk = std::max(natoms, size_t(1));
 
     ncfile.add_variable<float>("coordinates", "frame", "atom", "spatial");
     ncfile.add_attribute("coordinates", "units", "angstrom");
+    ncfile.compress_variable("coordinates", {1, atoms_chunk, 3});
 
     ncfile.add_variable<float>("cell_lengths", "frame", "cell_spatial");
     ncfile.add_attribute("cell_lengths", "units", "angstrom");
+    ncfile.compress_variable("cell_lengths", {1, 3});
 
     ncfile.add_variable<float>("cell_angles", "frame", "cell_angular");
     ncfile.add_attribute("cell_angles", "units", "degree");
+    ncfile.compress_variable("cell_angles", {1, 3});
 
     if (velocities) {
         ncfile.add_variable<float>("velocities", "frame", "atom", "spatial");
         ncfile.add_attribute("velocities", "units", "angstrom/picosecond");
+        ncfile.compress_variable("velocities", {1, atoms_chunk, 3});
     }
+
+    ncfile.end_definitions();
+
+    ncfile.variable("spatial").putVar("xyz");
+    ncfile.variable("cell_spatial").putVar("abc");
+    const char angles[3][10]{"alpha", "beta", "gamma"};
+    ncfile.variable("cell_angular").putVar(angles);
 }
 
 void NCFormat::write(const Frame& frame) {
-    auto natoms = frame.natoms();
     // If we created the file, let's initialize it.
     if (!validated) {
-        initialize(ncfile, natoms, frame.has_velocities());
-        assert(is_valid(ncfile, natoms));
+        initialize(ncfile, frame.natoms(), frame.has_velocities());
+        assert(is_valid(ncfile, frame.natoms()));
         validated = true;
+        setup();
+    }
+
+    if (frame.natoms() != natoms) {
+        throw FormatError(
+            "Can not write a frame with " + std::to_string(frame.natoms()) +
+            " atoms to an Amber NetCDF file with " + std::to_string(natoms) + " atoms."
+        );
     }
+
     write_cell(frame.cell());
-    write_array3D(frame.positions(), "coordinates");
+    write_array3D(frame.positions(), coordinates);
     if (frame.has_velocities())
-        write_array3D(frame.velocities(), "velocities");
+        write_array3D(frame.velocities(), velocities);
 
     step++;
 }
 
-void NCFormat::write_array3D(const Array3D& arr, const string& name) const {
-    auto var = ncfile.variable(name);
-    auto natoms = arr.size();
+void NCFormat::write_array3D(const Array3D& arr, const NcVar& var) const {
+    if (var.isNull() || natoms == 0) {
+        return;
+    }
     vector<size_t> start{step, 0, 0};
     vector<size_t> count{1, natoms, 3};
-
-    auto data = vector<float>(natoms * 3);
-    for (size_t i=0; i<natoms; i++){
-        data[3*i + 0] = arr[i][0];
-        data[3*i + 1] = arr[i][1];
-        data[3*i + 2] = arr[i][2];
-    }
-    var.putVar(start, count, data.data());
+    // Write directly from the array memory, Vector3D has the same layout as float[3]
+    var.putVar(start, count, arr[0].data());
 }
 
 void NCFormat::write_cell(const UnitCell& cell) const {
-    auto length = ncfile.variable("cell_lengths");
-    auto angles = ncfile.variable("cell_angles");
-
     float length_data[3], angles_data[3];
     length_data[0] = static_cast<float>(cell.a());
     length_data[1] = static_cast<float>(cell.b());
@@ -239,8 +386,8 @@ void NCFormat::write_cell(const UnitCell& cell) const {
 
     vector<size_t> start{step, 0};
     vector<size_t> count{1, 3};
-    length.putVar(start, count, length_data);
-    angles.putVar(start, count, angles_data);
+    cell_lengths.putVar(start, count, length_data);
+    cell_angles.putVar(start, count, angles_data);
 }
 
 #endif // HAVE_NETCDF
@@ -7,6 +7,10 @@
 */
 #include <sstream>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 #include "chemfiles/formats/XYZ.hpp"
 
@@ -17,6 +21,11 @@
 
 using namespace chemfiles;
 
+// Maximal number of decimals when writing positions
+static const unsigned MAX_PRECISION = 9;
+// Size of the formatted data to accumulate before writing it to the file
+static const size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+
 std::string XYZFormat::description() const {
     return "XYZ file format.";
 }
@@ -45,7 +54,37 @@ static bool forward(TextFile& file, size_t nsteps) {
     return true;
 }
 
-XYZFormat::XYZFormat(File& f) : Format(f), textfile(static_cast<TextFile&>(file)) {}
+bool XYZFormat::sniff(const std::string& header) {
+    std::istringstream input(header);
+    std::string line;
+    if (!std::getline(input, line)) {
+        return false;
+    }
+    auto first = line.find_first_not_of(" \t");
+    auto last = line.find_last_not_of(" \t\r");
+    if (first == std::string::npos || line.find_first_not_of("0123456789", first) <= last) {
+        return false;
+    }
+    auto natoms = line.substr(first, last - first + 1);
+
+    // Comment line
+    if (!std::getline(input, line)) {
+        return false;
+    }
+    if (natoms.find_first_not_of('0') == std::string::npos) {
+        return true;
+    }
+    if (!std::getline(input, line) || input.eof()) {
+        // The first atom is not complete in the header
+        return true;
+    }
+    std::istringstream atom(line);
+    std::string name;
+    double x, y, z;
+    return static_cast<bool>(atom >> name >> x >> y >> z);
+}
+
+XYZFormat::XYZFormat(File& f) : Format(f), textfile(static_cast<TextFile&>(file)), _precision(5) {}
 
 size_t XYZFormat::nsteps() const {
     textfile.rewind();
@@ -64,6 +103,18 @@ void XYZFormat::read_step(const size_t step, Frame& frame){
     read(frame);
 }
 
+// Read the name and position of an atom in an XYZ line
+static void read_atom(const std::string& line, Vector3D& position, Topology& topology) {
+    std::istringstream string_stream;
+    float x, y, z;
+    string name;
+
+    string_stream.str(line);
+    string_stream >> name >> x >> y >> z ;
+    position = Vector3D(x, y, z);
+    topology.append(Atom(name));
+}
+
 void XYZFormat::read(Frame& frame){
     size_t natoms;
 
@@ -83,35 +134,170 @@ void XYZFormat::read(Frame& frame){
         throw FormatError("Can not read file: " + string(e.what()));
     }
 
-    frame.topology().clear();
-    frame.resize(natoms);
+    auto& topology = frame.topology();
+    topology.clear();
 
-    for (size_t i=0; i<lines.size(); i++) {
-        std::istringstream string_stream;
-        float x, y, z;
-        string name;
+    if (_selection.empty()) {
+        topology.reserve(natoms);
+        frame.resize(natoms);
+        for (size_t i=0; i<lines.size(); i++) {
+            read_atom(lines[i], frame.positions()[i], topology);
+        }
+    } else {
+        // Only parse the lines of the selected atoms
+        if (_selection.back() >= natoms) {
+            throw FormatError(
+                "Can not select the atom " + std::to_string(_selection.back()) +
+                " in a frame with " + std::to_string(natoms) + " atoms."
+            );
+        }
+        topology.reserve(_selection.size());
+        frame.resize(_selection.size());
+        for (size_t i=0; i<_selection.size(); i++) {
+            read_atom(lines[_selection[i]], frame.positions()[i], topology);
+        }
+    }
+}
 
-        string_stream.str(lines[i]);
-        string_stream >> name >> x >> y >> z ;
-        frame.positions()[i] = Vector3D(x, y, z);
-        frame.topology().append(Atom(name));
+bool XYZFormat::selection(const std::vector<size_t>& atoms) {
+    _selection = atoms;
+    return true;
+}
+
+void XYZFormat::option(const std::string& name, double value) {
+    if (name != "precision") {
+        Format::option(name, value);
+        return;
     }
+    if (!(value >= 0 && value <= MAX_PRECISION) || std::floor(value) != value) {
+        throw FormatError(
+            "The precision of XYZ files must be an integer between 0 and " +
+            std::to_string(MAX_PRECISION) + ", got " + std::to_string(value) + "."
+        );
+    }
+    _precision = static_cast<unsigned>(value);
+}
+
+// Pairs of decimal digits, used to format two digits at once
+static const char DIGITS_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write the decimal representation of \c value at \c output, and return the
+// end of the written characters.
+static char* format_integer(char* output, uint64_t value) {
+    char digits[20];
+    auto end = digits + 20;
+    auto start = end;
+    while (value >= 100) {
+        auto pair = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        start -= 2;
+        start[0] = DIGITS_PAIRS[pair];
+        start[1] = DIGITS_PAIRS[pair + 1];
+    }
+    if (value >= 10) {
+        auto pair = static_cast<size_t>(value) * 2;
+        start -= 2;
+        start[0] = DIGITS_PAIRS[pair];
+        start[1] = DIGITS_PAIRS[pair + 1];
+    } else {
+        *--start = static_cast<char>('0' + value);
+    }
+    while (start != end) {
+        *output++ = *start++;
+    }
+    return output;
+}
+
+// Write \c value with \c precision decimals at \c output, removing the
+// trailing zeros, and return the end of the written characters. There must be
+// at least 64 characters available in \c output.
+static char* format_float(char* output, float value, unsigned precision) {
+    static const uint32_t POWERS_OF_TEN[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    auto divisor = POWERS_OF_TEN[precision];
+    auto scaled = static_cast<double>(value) * divisor;
+    if (!(std::fabs(scaled) < 1e18)) {
+        // Large values, infinity and NaN
+        auto count = std::snprintf(output, 64, "%.*f", static_cast<int>(precision), static_cast<double>(value));
+        auto end = output + count;
+        if (std::memchr(output, '.', static_cast<size_t>(count)) != nullptr) {
+            while (end[-1] == '0') {
+                end--;
+            }
+            if (end[-1] == '.') {
+                end--;
+            }
+        }
+        return end;
+    }
+
+    // Round to the closest integer, without printing "-0"
+    auto rounded = static_cast<uint64_t>(std::fabs(scaled) + 0.5);
+    if (scaled < 0 && rounded != 0) {
+        *output++ = '-';
+    }
+
+    uint64_t integral = 0;
+    uint32_t decimals = 0;
+    if (rounded <= UINT32_MAX) {
+        // 32-bit divisions are a lot faster
+        auto small = static_cast<uint32_t>(rounded);
+        integral = small / divisor;
+        decimals = small % divisor;
+    } else {
+        integral = rounded / divisor;
+        decimals = static_cast<uint32_t>(rounded % divisor);
+    }
+    output = format_integer(output, integral);
+
+    if (decimals != 0) {
+        *output++ = '.';
+        for (auto i=precision; i>0; i--) {
+            output[i - 1] = static_cast<char>('0' + decimals % 10);
+            decimals /= 10;
+        }
+        output += precision;
+        while (output[-1] == '0') {
+            output--;
+        }
+    }
+    return output;
 }
 
 void XYZFormat::write(const Frame& frame){
-    const auto topology = frame.topology();
-    const auto positions = frame.positions();
+    const auto& topology = frame.topology();
+    const auto& positions = frame.positions();
     assert(frame.natoms() == topology.natoms());
 
-    textfile << frame.natoms() << "\n";
-    textfile << "Written by the chemfiles library\n";
+    _buffer.clear();
+    _buffer += std::to_string(frame.natoms());
+    _buffer += "\nWritten by the chemfiles library\n";
 
+    char line[4 * 64];
     for (size_t i=0; i<frame.natoms(); i++){
-        auto& pos = positions[i];
-        auto name = topology[i].name();
-        if (name == "")
-            name = "X";
-        textfile << name   << " "
-                  << pos[0] << " " << pos[1] << " " << pos[2] << "\n";
+        const auto& name = topology[i].name();
+        if (name.empty()) {
+            _buffer += 'X';
+        } else {
+            _buffer += name;
+        }
+
+        auto end = line;
+        for (size_t j=0; j<3; j++) {
+            *end++ = ' ';
+            end = format_float(end, positions[i][j], _precision);
+        }
+        *end++ = '\n';
+        _buffer.append(line, static_cast<size_t>(end - line));
+
+        if (_buffer.size() >= WRITE_BUFFER_SIZE) {
+            textfile.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.clear();
+        }
     }
+    textfile.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
 }
@@ -52,4 +52,23 @@ TEST_CASE("Use the Atom type", "[Atoms]"){
         CHECK(a3.covalent_radius() == -1.0f);
         CHECK(a3.vdw_radius() == -1.0f);
     }
+
+    SECTION("Elements lookup"){
+        CHECK(Atom("Ag").type() == Atom::ELEMENT);
+        CHECK(Atom("Tl").type() == Atom::ELEMENT);
+        CHECK(Atom("Xx").type() == Atom::CORSE_GRAIN);
+        CHECK(Atom("Hg2").type() == Atom::CORSE_GRAIN);
+
+        CHECK(Atom("Xx").atomic_number() == 0);
+        CHECK(Atom("Xx").full_name() == "Dummy");
+        CHECK(Atom("Uuo").atomic_number() == 118);
+
+        a3.name("Fe");
+        CHECK(a3.atomic_number() == 26);
+        // Names are interned
+        CHECK(&a3.name() == &Atom("Fe").name());
+        CHECK(a3.full_name() == "Iron");
+        a3.name("Fe2+");
+        CHECK(a3.atomic_number() == -1);
+    }
 }
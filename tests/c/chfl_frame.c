@@ -37,6 +37,22 @@ int main() {
         for (unsigned j=0; j<3; j++)
             assert(fabs(data[i][j] - pos[i][j]) < 1e-9);
 
+    float (*pos_data)[3] = NULL;
+    size_t size = 0;
+    assert(!chfl_frame_positions_data(frame, &pos_data, &size));
+    assert(size == 4);
+    for (unsigned i=0; i<4; i++)
+        for (unsigned j=0; j<3; j++)
+            assert(fabs(data[i][j] - pos_data[i][j]) < 1e-9);
+    pos_data[2][1] = 42;
+    assert(!chfl_frame_positions(frame, pos, 4));
+    assert(fabs(pos[2][1] - 42) < 1e-9);
+    pos_data[2][1] = data[2][1];
+
+    float (*vel_data)[3] = NULL;
+    assert(!chfl_frame_velocities_data(frame, &vel_data, &size));
+    assert(vel_data == NULL);
+    assert(size == 0);
 
     bool has_vel = true;
     assert(!chfl_frame_has_velocities(frame, &has_vel));
@@ -52,6 +68,10 @@ int main() {
     assert(!chfl_frame_has_velocities(frame, &has_vel));
     assert(has_vel == true);
 
+    assert(!chfl_frame_velocities_data(frame, &vel_data, &size));
+    assert(size == 4);
+    assert(fabs(vel_data[3][2] - data[3][2]) < 1e-9);
+
     /*********************/
     CHFL_CELL* cell = chfl_cell(3, 4, 5);
     assert(!chfl_frame_set_cell(frame, cell));
@@ -81,6 +81,15 @@ int main() {
     for (unsigned j=0; j<4; j++)
         assert(dihedrals[0][j] == top_dihedrals[0][j]);
 
+    size_t all_bonds[3][2], all_dihedrals[1][4];
+    assert(!chfl_topology_connectivity(topology, all_bonds, 3, NULL, 0, all_dihedrals, 1));
+    for (unsigned i=0; i<3; i++)
+        for (unsigned j=0; j<2; j++)
+            assert(all_bonds[i][j] == top_bonds[i][j]);
+    for (unsigned j=0; j<4; j++)
+        assert(all_dihedrals[0][j] == top_dihedrals[0][j]);
+    assert(chfl_topology_connectivity(topology, all_bonds, 2, NULL, 0, NULL, 0));
+
     assert(!chfl_topology_remove_bond(topology, 2, 3));
     assert(!chfl_topology_bonds_count(topology, &n));
     assert(n == 2);
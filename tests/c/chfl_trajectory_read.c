@@ -117,10 +117,17 @@ int main(){
     assert(!chfl_trajectory_close(file));
 
     file = chfl_trajectory_with_format(DATADIR "helium.xyz.but.not.really", "r", "XYZ");
+    assert(!chfl_trajectory_enable_counters(file));
     assert(!chfl_trajectory_read(file, frame));
     assert(!chfl_frame_atoms_count(frame, &natoms));
     assert(natoms == 125);
 
+    chfl_counters_t counters;
+    assert(!chfl_trajectory_counters(file, &counters));
+    assert(counters.frames_read == 1);
+    assert(counters.frames_written == 0);
+    assert(counters.bytes_read > 0);
+
     assert(!chfl_frame_free(frame));
     assert(!chfl_trajectory_close(file));
 
@@ -0,0 +1,50 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "chemfiles.h"
+
+TEST_CASE("Errors in the C API", "[C API]"){
+    chfl_log_level_t level;
+    REQUIRE(!chfl_loglevel(&level));
+    REQUIRE(!chfl_set_loglevel(CHFL_LOG_NONE));
+
+    SECTION("Last error") {
+        CHECK(chfl_trajectory_open("not-here.xyz", "r") == nullptr);
+        CHECK(std::string(chfl_last_error()).find("not-here.xyz") != std::string::npos);
+    }
+
+    SECTION("Errors are stored per thread") {
+        const size_t nthreads = 8;
+        std::vector<std::string> errors(nthreads);
+        std::vector<std::thread> threads;
+        for (size_t i=0; i<nthreads; i++) {
+            threads.emplace_back([i, &errors](){
+                auto name = "not-here-" + std::to_string(i) + ".xyz";
+                for (size_t j=0; j<100; j++) {
+                    chfl_trajectory_open(name.c_str(), "r");
+                    if (std::string(chfl_last_error()).find(name) == std::string::npos) {
+                        errors[i] = chfl_last_error();
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        for (auto& error: errors) {
+            CHECK(error == "");
+        }
+
+        // Errors in other threads do not change the error in this thread
+        CHECK(chfl_trajectory_open("not-here.xyz", "r") == nullptr);
+        std::thread([](){
+            chfl_trajectory_open("other.xyz", "r");
+        }).join();
+        CHECK(std::string(chfl_last_error()).find("not-here.xyz") != std::string::npos);
+    }
+
+    REQUIRE(!chfl_set_loglevel(level));
+}
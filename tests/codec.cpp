@@ -0,0 +1,96 @@
+#include <cmath>
+#include <random>
+
+#include "catch.hpp"
+
+#include "chemfiles.hpp"
+#include "chemfiles/Codec.hpp"
+using namespace chemfiles;
+
+static bool within(const Array3D& actual, const Array3D& expected, double tolerance) {
+    if (actual.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i=0; i<actual.size(); i++) {
+        for (size_t j=0; j<3; j++) {
+            if (std::fabs(actual[i][j] - expected[i][j]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Lossy compression of arrays", "[Codec]"){
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> positions(-50, 50);
+    std::uniform_real_distribution<float> moves(-0.1f, 0.1f);
+
+    Array3D array(1000);
+    for (auto& vector: array) {
+        vector = Vector3D(positions(random), positions(random), positions(random));
+    }
+
+    SECTION("Keyframes and deltas") {
+        LossyCodec encoder(1e-3);
+        LossyCodec decoder(1e-3);
+        CHECK(encoder.precision() == 1e-3);
+
+        Array3D decoded;
+        for (size_t step=0; step<10; step++) {
+            for (auto& vector: array) {
+                vector = vector + Vector3D(moves(random), moves(random), moves(random));
+            }
+            auto keyframe = step % 4 == 0;
+            std::vector<char> output;
+            encoder.encode(array, keyframe, output);
+            if (!keyframe) {
+                // Small moves are much smaller than the uncompressed data
+                CHECK(output.size() < array.size() * 3 * sizeof(float) / 2);
+            }
+
+            decoder.decode(output.data(), output.size(), keyframe, decoded);
+            // Rounding to float adds a small error to the precision
+            CHECK(within(decoded, array, 0.5e-3 + 1e-4));
+        }
+    }
+
+    SECTION("Special arrays") {
+        LossyCodec codec(0.01);
+        std::vector<char> output;
+        Array3D decoded;
+
+        codec.encode(Array3D(), true, output);
+        codec.decode(output.data(), output.size(), true, decoded);
+        CHECK(decoded.empty());
+
+        output.clear();
+        codec.encode(Array3D(300), true, output);
+        codec.decode(output.data(), output.size(), true, decoded);
+        CHECK(within(decoded, Array3D(300), 0));
+
+        auto large = Array3D{Vector3D(1e6f, -1e6f, 0), Vector3D(-1e6f, 1e6f, 3)};
+        output.clear();
+        codec.encode(large, true, output);
+        codec.decode(output.data(), output.size(), true, decoded);
+        CHECK(within(decoded, large, 0.1));
+    }
+
+    SECTION("Errors") {
+        CHECK_THROWS_AS(LossyCodec(0), Error);
+        CHECK_THROWS_AS(LossyCodec(-1), Error);
+
+        LossyCodec codec(1e-3);
+        std::vector<char> output;
+        // Too large for this precision
+        CHECK_THROWS_AS(codec.encode(Array3D{Vector3D(1e7f, 0, 0)}, true, output), FormatError);
+
+        // Delta encoding needs an array with the same size
+        codec.encode(array, true, output);
+        CHECK_THROWS_AS(codec.encode(Array3D(3), false, output), Error);
+
+        Array3D decoded;
+        CHECK_THROWS_AS(codec.decode(output.data(), 4, true, decoded), FormatError);
+        CHECK_THROWS_AS(codec.decode(output.data(), 20, true, decoded), FormatError);
+    }
+}
@@ -1,5 +1,7 @@
 #ifndef WIN32
 
+#include <algorithm>
+#include <fstream>
 #include <string>
 
 #include "catch.hpp"
@@ -37,24 +39,28 @@ public:
 };
 
 TEST_CASE("Registering a new format", "[Trajectory factory]"){
-    TrajectoryFactory::get().register_extension(".testing", {nullptr, nullptr});
+    TrajectoryFactory::get().register_extension(".testing", {nullptr, nullptr, false, nullptr});
     // We can not register the same format twice
     CHECK_THROWS_AS(
-        TrajectoryFactory::get().register_extension(".testing", {nullptr, nullptr}),
+        TrajectoryFactory::get().register_extension(".testing", {nullptr, nullptr, false, nullptr}),
         FormatError
     );
 
-    TrajectoryFactory::get().register_format("Testing", {nullptr, nullptr});
+    TrajectoryFactory::get().register_format("Testing", {nullptr, nullptr, false, nullptr});
     // We can not register the same format twice
     CHECK_THROWS_AS(
-        TrajectoryFactory::get().register_format("Testing", {nullptr, nullptr}),
+        TrajectoryFactory::get().register_format("Testing", {nullptr, nullptr, false, nullptr}),
         FormatError
     );
 }
 
 TEST_CASE("Geting registered format", "[Trajectory factory]"){
-    TrajectoryFactory::get().register_extension(".dummy", {new_format<DummyFormat>, new_file<typename DummyFormat::file_t>});
-    TrajectoryFactory::get().register_format("Dummy", {new_format<DummyFormat>, new_file<typename DummyFormat::file_t>});
+    TrajectoryFactory::get().register_extension(".dummy", {
+        new_format<DummyFormat>, new_file<typename DummyFormat::file_t>, false, nullptr
+    });
+    TrajectoryFactory::get().register_format("Dummy", {
+        new_format<DummyFormat>, new_file<typename DummyFormat::file_t>, false, nullptr
+    });
 
     BasicFile file("tmp.dat", "w");
 
@@ -69,13 +75,107 @@ TEST_CASE("Geting registered format", "[Trajectory factory]"){
     CHECK(typeid(XYZ) == typeid(*format));
     format = TrajectoryFactory::get().format("XYZ").format_creator(file);
     CHECK(typeid(XYZ) == typeid(*format));
+    // XYZ files need to be read from the start to find a step
+    CHECK_FALSE(format->random_access());
 
     CHECK_THROWS_AS(TrajectoryFactory::get().format("UNKOWN"), FormatError);
     CHECK_THROWS_AS(TrajectoryFactory::get().by_extension(".UNKOWN"), FormatError);
 }
 
+TEST_CASE("Listing the registered formats", "[Trajectory factory]"){
+    auto names = TrajectoryFactory::get().names();
+    CHECK(std::is_sorted(names.begin(), names.end()));
+    CHECK(std::find(names.begin(), names.end(), "XYZ") != names.end());
+    CHECK(std::find(names.begin(), names.end(), "ChemfilesBinary") != names.end());
+}
+
+// Dummy format recognizing files starting with "DUMMY"
+class SniffedFormat : public Format {
+public:
+    SniffedFormat(File& file) : Format(file){}
+    std::string description() const override {return "";}
+    size_t nsteps() const override {return 42;}
+    static bool sniff(const std::string& header) {return header.compare(0, 5, "DUMMY") == 0;}
+};
+
+static void write_content(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+}
+
+TEST_CASE("Guessing the format from the file content", "[Trajectory factory]"){
+    auto& factory = TrajectoryFactory::get();
+    auto XYZ = factory.format("XYZ");
+    auto binary = factory.format("ChemfilesBinary");
+    CHECK(XYZ.sniff != nullptr);
+    CHECK(binary.sniff != nullptr);
+
+    SECTION("Formats") {
+        CHECK(XYZ.sniff("3\nwater\nO 0 0 0\nH 1 0 0\nH 0 1 0\n"));
+        CHECK(XYZ.sniff("  2 \r\n\nO 0 0 0\nO 0 0"));
+        CHECK(XYZ.sniff("0\n\n"));
+        CHECK_FALSE(XYZ.sniff("3\nwater\nO 0 zero 0\n"));
+        CHECK_FALSE(XYZ.sniff("water\n3\n"));
+        CHECK_FALSE(XYZ.sniff("3"));
+        CHECK_FALSE(XYZ.sniff(""));
+        CHECK(binary.sniff(std::string("CHFLBIN\0\x01", 9)));
+        CHECK_FALSE(binary.sniff("CHFL"));
+
+        CHECK(factory.format("PDB").sniff("HEADER    water\nATOM      1  O"));
+        CHECK(factory.format("PDB").sniff("ATOM      1  O"));
+        CHECK_FALSE(factory.format("PDB").sniff("ATOMS\n"));
+        CHECK(factory.format("GRO").sniff("water\n    3\n    1SOL     OW    1   0.126   1.624   1.679\n"));
+        CHECK_FALSE(factory.format("GRO").sniff("3\nwater\nO 0 0 0\n"));
+        CHECK(factory.format("XTC").sniff(std::string("\0\0\x07\xcb", 4)));
+        CHECK(factory.format("TRR").sniff(std::string("\0\0\x07\xc9", 4)));
+        CHECK(factory.format("DCD").sniff(std::string("\x54\0\0\0CORD", 8)));
+        CHECK_FALSE(factory.format("DCD").sniff(std::string("\x54\0\0\0VELO", 8)));
+    }
+
+    SECTION("Files") {
+        write_content("tmp-sniff.out", "1\nhelium\nHe 1 2 3\n");
+        CHECK(factory.by_content("tmp-sniff.out").format_creator == XYZ.format_creator);
+        CHECK(factory.guess("tmp-sniff.out", "r").format_creator == XYZ.format_creator);
+
+        Trajectory file("tmp-sniff.out");
+        CHECK(file.nsteps() == 1);
+        CHECK(file.read().positions()[0] == Vector3D(1, 2, 3));
+
+        // Known extensions do not need to read the file
+        CHECK(factory.guess("not-here.chfl", "r").format_creator == binary.format_creator);
+        // The format of new files comes only from their extension
+        CHECK_THROWS_AS(factory.guess("tmp-sniff.out", "w"), FormatError);
+    }
+
+    SECTION("Registered formats") {
+        factory.register_format("Sniffed", {
+            new_format<SniffedFormat>, new_file<SniffedFormat::file_t>, true, SniffedFormat::sniff
+        });
+        write_content("tmp-sniff.out", "DUMMY file\n");
+        auto creator = &new_format<SniffedFormat>;
+        CHECK(factory.by_content("tmp-sniff.out").format_creator == creator);
+    }
+
+    SECTION("Errors") {
+        write_content("tmp-sniff.out", "not a trajectory\n");
+        CHECK_THROWS_AS(factory.by_content("tmp-sniff.out"), FormatError);
+        CHECK_THROWS_AS(Trajectory("tmp-sniff.out"), FormatError);
+
+        write_content("tmp-sniff.out", "\x1f\x8b\x08\x00");
+        CHECK_THROWS_AS(factory.by_content("tmp-sniff.out"), FormatError);
+
+        CHECK_THROWS_AS(factory.by_content("not-here.out"), FileError);
+        // Missing files keep the error about their extension
+        CHECK_THROWS_AS(factory.guess("not-here.out", "r"), FormatError);
+    }
+
+    remove("tmp-sniff.out");
+}
+
 TEST_CASE("Geting file type associated to a format", "[Trajectory factory]"){
-    TrajectoryFactory::get().register_extension(".dummy2", {new_format<DummyFormat2>, new_file<typename DummyFormat2::file_t>});
+    TrajectoryFactory::get().register_extension(".dummy2", {
+        new_format<DummyFormat2>, new_file<typename DummyFormat2::file_t>, false, nullptr
+    });
     DummyFile dummy("", "");
     auto file = TrajectoryFactory::get().by_extension(".dummy2").file_creator;
     CHECK(typeid(dummy) == typeid(*file("", "")));
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <cstring>
+
+#include "catch.hpp"
+
+#include "chemfiles.hpp"
+#include "chemfiles/files/RawFile.hpp"
+using namespace chemfiles;
+
+TEST_CASE("Read and write a raw binary file", "[Files]"){
+    {
+        RawFile file("tmp.raw", "w");
+        REQUIRE(file.is_open());
+        CHECK(file.size() == 0);
+
+        file.write(0, "hello", 5);
+        file.write(10, "world", 5);
+        CHECK(file.size() == 15);
+        // Writing before the end
+        file.write(2, "LL", 2);
+        CHECK(file.size() == 15);
+    }
+
+    {
+        RawFile file("tmp.raw", "r");
+        CHECK(file.size() == 15);
+        CHECK(std::strncmp(file.read(0, 5), "heLLo", 5) == 0);
+        CHECK(std::strncmp(file.read(10, 5), "world", 5) == 0);
+        // Read the file in any order
+        CHECK(std::strncmp(file.read(3, 2), "Lo", 2) == 0);
+
+        CHECK_THROWS_AS(file.read(12, 5), FileError);
+        CHECK_THROWS_AS(file.write(0, "a", 1), FileError);
+    }
+
+    {
+        RawFile file("tmp.raw", "a");
+        CHECK(file.size() == 15);
+        CHECK(std::strncmp(file.read(0, 5), "heLLo", 5) == 0);
+        file.write(15, "!", 1);
+        CHECK(std::strncmp(file.read(14, 2), "d!", 2) == 0);
+    }
+
+    remove("tmp.raw");
+}
+
+TEST_CASE("Errors in raw binary files", "[Files]"){
+    CHECK_THROWS_AS(RawFile("not-a-file.raw", "r"), FileError);
+    CHECK_THROWS_AS(RawFile("tmp.raw", "z"), FileError);
+}
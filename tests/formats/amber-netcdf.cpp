@@ -5,6 +5,7 @@
 #if HAVE_NETCDF
 
 #include "chemfiles.hpp"
+#include "chemfiles/files/NCFile.hpp"
 using namespace chemfiles;
 
 #include <boost/filesystem.hpp>
@@ -96,4 +97,138 @@ TEST_CASE("Write files in NetCDF format", "[Amber NetCDF]"){
     }
 }
 
+TEST_CASE("Sync NetCDF files while writing", "[Amber NetCDF]"){
+    Trajectory file("tmp-sync.nc", "w");
+    Frame frame(4);
+    for (size_t step=0; step<5; step++) {
+        frame.positions()[0] = Vector3D(static_cast<float>(step), 0, 0);
+        file << frame;
+        file.sync();
+
+        // The frames are visible from other readers after a sync
+        Trajectory check("tmp-sync.nc", "r");
+        CHECK(check.nsteps() == step + 1);
+        CHECK(roughly(check.read_step(step).positions()[0], Vector3D(static_cast<float>(step), 0, 0), 1e-4));
+    }
+
+    remove("tmp-sync.nc");
+}
+
+TEST_CASE("Write compressed NetCDF 4 files", "[Amber NetCDF]"){
+    {
+        Trajectory file("tmp-nc4.nc", "w", "AmberNetCDF4");
+        Frame frame(1000);
+        for (size_t step=0; step<10; step++) {
+            for (size_t i=0; i<1000; i++) {
+                frame.positions()[i] = Vector3D(static_cast<float>(step), static_cast<float>(i % 10), 3);
+            }
+            frame.cell(UnitCell(10 + static_cast<double>(step)));
+            file << frame;
+        }
+    }
+
+    // Check the file uses the NetCDF 4 format and is compressed
+    {
+        NCFile ncfile("tmp-nc4.nc", "r");
+        CHECK(ncfile.netcdf4());
+    }
+    CHECK(fs::file_size("tmp-nc4.nc") < 10 * 1000 * 3 * sizeof(float) / 2);
+
+    // Both Amber NetCDF formats can read the file
+    for (auto format: {"AmberNetCDF", "AmberNetCDF4"}) {
+        Trajectory file("tmp-nc4.nc", "r", format);
+        CHECK(file.nsteps() == 10);
+        auto frame = file.read_step(7);
+        CHECK(roughly(frame.positions()[123], Vector3D(7, 3, 3), 1e-4));
+        CHECK(fabs(frame.cell().a() - 17) < EPS);
+        // Sequential reads continue after the last step read
+        CHECK(roughly(file.read().positions()[123], Vector3D(8, 3, 3), 1e-4));
+    }
+
+    // Appending to the file keeps the NetCDF 4 format
+    {
+        Trajectory file("tmp-nc4.nc", "a", "AmberNetCDF");
+        Frame frame(1000);
+        file << frame;
+    }
+    Trajectory file("tmp-nc4.nc");
+    CHECK(file.nsteps() == 11);
+    {
+        NCFile ncfile("tmp-nc4.nc", "r");
+        CHECK(ncfile.netcdf4());
+    }
+
+    remove("tmp-nc4.nc");
+}
+
+TEST_CASE("Read blocks of frames in NetCDF format", "[Amber NetCDF]"){
+    {
+        Trajectory file("tmp-block.nc", "w");
+        Frame frame(4);
+        for (size_t step=0; step<10; step++) {
+            for (size_t i=0; i<4; i++) {
+                frame.positions()[i] = Vector3D(static_cast<float>(step), static_cast<float>(i), 3);
+            }
+            frame.cell(UnitCell(10 + static_cast<double>(step)));
+            file << frame;
+        }
+    }
+
+    Trajectory file("tmp-block.nc");
+    std::vector<Frame> frames;
+
+    file.read_block(1, 10, 3, frames);
+    REQUIRE(frames.size() == 3);
+    for (size_t i=0; i<3; i++) {
+        auto step = 1 + 3 * i;
+        CHECK(frames[i].natoms() == 4);
+        CHECK(roughly(frames[i].positions()[2], Vector3D(static_cast<float>(step), 2, 3), 1e-4));
+        CHECK(fabs(frames[i].cell().a() - (10 + static_cast<double>(step))) < EPS);
+    }
+
+    // Frames are reused
+    file.read_block(0, 10, 1, frames);
+    REQUIRE(frames.size() == 10);
+    CHECK(roughly(frames[9].positions()[3], Vector3D(9, 3, 3), 1e-4));
+    CHECK(file.done());
+
+    CHECK(file.read_block(5, 5).empty());
+    CHECK_THROWS_AS(file.read_block(0, 11, 1, frames), FileError);
+    CHECK_THROWS_AS(file.read_block(0, 10, 0, frames), Error);
+
+    remove("tmp-block.nc");
+}
+
+TEST_CASE("Read a selection of atoms in NetCDF format", "[Amber NetCDF]"){
+    {
+        Trajectory file("tmp-selection.nc", "w");
+        Frame frame(6);
+        for (size_t step=0; step<3; step++) {
+            for (size_t i=0; i<6; i++) {
+                frame.positions()[i] = Vector3D(static_cast<float>(step), static_cast<float>(i), 3);
+            }
+            file << frame;
+        }
+    }
+
+    Trajectory file("tmp-selection.nc");
+    file.selection({5, 0, 1, 3});
+
+    auto frame = file.read_step(1);
+    REQUIRE(frame.natoms() == 4);
+    CHECK(roughly(frame.positions()[0], Vector3D(1, 0, 3), 1e-4));
+    CHECK(roughly(frame.positions()[1], Vector3D(1, 1, 3), 1e-4));
+    CHECK(roughly(frame.positions()[2], Vector3D(1, 3, 3), 1e-4));
+    CHECK(roughly(frame.positions()[3], Vector3D(1, 5, 3), 1e-4));
+
+    auto frames = file.read_block(0, 3);
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[2].natoms() == 4);
+    CHECK(roughly(frames[2].positions()[3], Vector3D(2, 5, 3), 1e-4));
+
+    CHECK_THROWS_AS(file.selection({6}), Error);
+
+    remove("tmp-selection.nc");
+}
+
 #endif // HAVE_NETCDF
@@ -0,0 +1,252 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+
+#include "catch.hpp"
+#include "chemfiles.hpp"
+#include "chemfiles/File.hpp"
+#include "chemfiles/Format.hpp"
+#include "chemfiles/TrajectoryFactory.hpp"
+using namespace chemfiles;
+
+static Frame make_frame(size_t step) {
+    Topology topology;
+    topology.append(Atom("O"));
+    topology.append(Atom("H"));
+    topology.append(Atom("H"));
+    topology.add_bond(0, 1);
+    topology.add_bond(0, 2);
+
+    Frame frame;
+    frame.topology(topology);
+    frame.resize(3, true);
+    frame.step(step);
+    frame.cell(UnitCell(10, 11, 12, 90, 80, 120));
+    for (size_t i=0; i<3; i++) {
+        frame.positions()[i] = Vector3D(static_cast<float>(step), static_cast<float>(i), 0.5f);
+        frame.velocities()[i] = Vector3D(-1, static_cast<float>(step), static_cast<float>(i));
+    }
+    return frame;
+}
+
+TEST_CASE("Read and write files in chemfiles binary format", "[Binary]"){
+    {
+        Trajectory file("tmp.chfl", "w");
+        for (size_t step=0; step<10; step++) {
+            file << make_frame(step);
+        }
+    }
+
+    SECTION("Read the file") {
+        Trajectory file("tmp.chfl");
+        CHECK(file.nsteps() == 10);
+
+        const auto frame = file.read_step(7);
+        CHECK(frame.natoms() == 3);
+        CHECK(frame.step() == 7);
+        CHECK(frame.positions()[2] == Vector3D(7, 2, 0.5f));
+        CHECK(frame.velocities()[1] == Vector3D(-1, 7, 1));
+
+        auto cell = frame.cell();
+        CHECK(cell.type() == UnitCell::TRICLINIC);
+        CHECK(cell.b() == 11);
+        CHECK(cell.gamma() == 120);
+
+        const auto& topology = frame.topology();
+        CHECK(topology.natoms() == 3);
+        CHECK(topology[0].name() == "O");
+        CHECK(topology.isbond(0, 2));
+        CHECK(topology.isangle(1, 0, 2));
+
+        // The topology is shared between the frames
+        auto other = file.read_step(2);
+        CHECK(other.shared_topology() == frame.shared_topology());
+        CHECK(other.positions()[0] == Vector3D(2, 0, 0.5f));
+    }
+
+    SECTION("Append to the file") {
+        {
+            Trajectory file("tmp.chfl", "a");
+            CHECK(file.nsteps() == 10);
+            auto frame = make_frame(10);
+            frame.velocities().clear();
+            file << frame;
+        }
+        Trajectory file("tmp.chfl");
+        CHECK(file.nsteps() == 11);
+        auto frame = file.read_step(10);
+        CHECK(frame.positions()[1] == Vector3D(10, 1, 0.5f));
+        CHECK_FALSE(frame.has_velocities());
+        CHECK(file.read_step(9).positions()[1] == Vector3D(9, 1, 0.5f));
+        // Sequential reads continue after the last step read
+        CHECK(file.read().positions()[1] == Vector3D(10, 1, 0.5f));
+        CHECK(file.done());
+    }
+
+    SECTION("Random access") {
+        auto builder = TrajectoryFactory::get().format("ChemfilesBinary");
+        auto file = builder.file_creator("tmp.chfl", "r");
+        auto format = builder.format_creator(*file);
+        CHECK(format->random_access());
+    }
+
+    SECTION("Errors") {
+        Trajectory file("tmp.chfl", "a");
+        CHECK_THROWS_AS(file.write(Frame(5)), FormatError);
+    }
+
+    remove("tmp.chfl");
+}
+
+TEST_CASE("Recover chemfiles binary files", "[Binary]"){
+    {
+        Trajectory file("tmp-recover.chfl", "w");
+        for (size_t step=0; step<5; step++) {
+            file << make_frame(step);
+            file.sync();
+            // Frames are available to readers before closing the file
+            Trajectory check("tmp-recover.chfl");
+            CHECK(check.nsteps() == step + 1);
+        }
+    }
+
+    // Remove the index and a part of the last frame, as if the writer was
+    // killed while writing it
+    std::string content;
+    {
+        std::ifstream file("tmp-recover.chfl", std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    content.resize(content.size() - 5 * 8 - 20);
+    for (size_t i=40; i<48; i++) {
+        content[i] = 0;
+    }
+    {
+        std::ofstream file("tmp-recover.chfl", std::ios::binary);
+        file << content;
+    }
+
+    {
+        Trajectory file("tmp-recover.chfl");
+        CHECK(file.nsteps() == 4);
+        CHECK(file.read_step(3).positions()[0] == Vector3D(3, 0, 0.5f));
+    }
+
+    // Appending overwrites the incomplete frame
+    {
+        Trajectory file("tmp-recover.chfl", "a");
+        file << make_frame(42);
+    }
+    Trajectory file("tmp-recover.chfl");
+    CHECK(file.nsteps() == 5);
+    CHECK(file.read_step(4).step() == 42);
+
+    remove("tmp-recover.chfl");
+}
+
+TEST_CASE("Compressed chemfiles binary files", "[Binary]"){
+    {
+        Trajectory file("tmp-compressed.chfl", "w");
+        file.option("precision", 1e-3);
+        for (size_t step=0; step<100; step++) {
+            auto frame = make_frame(step);
+            frame.positions()[0] = Vector3D(static_cast<float>(step) / 7.f, 3.1415f, -2.7182f);
+            file << frame;
+        }
+        CHECK_THROWS_AS(file.option("precision", 1e-2), FormatError);
+    }
+
+    SECTION("Read the file") {
+        Trajectory file("tmp-compressed.chfl");
+        CHECK(file.nsteps() == 100);
+        for (size_t step=0; step<100; step++) {
+            auto frame = file.read();
+            CHECK(frame.step() == step);
+            CHECK(frame.topology()[0].name() == "O");
+            CHECK(std::fabs(frame.positions()[0][0] - static_cast<float>(step) / 7.f) < 1e-3);
+            CHECK(std::fabs(frame.positions()[0][1] - 3.1415f) < 1e-3);
+            CHECK(frame.positions()[2] == Vector3D(static_cast<float>(step), 2, 0.5f));
+            CHECK(frame.velocities()[1] == Vector3D(-1, static_cast<float>(step), 1));
+        }
+
+        // Random access needs to decode from the previous keyframe
+        for (auto step: std::initializer_list<size_t>{77, 3, 64, 65, 31, 99, 0}) {
+            auto frame = file.read_step(step);
+            CHECK(frame.step() == step);
+            CHECK(frame.positions()[1] == Vector3D(static_cast<float>(step), 1, 0.5f));
+            CHECK(std::fabs(frame.positions()[0][0] - static_cast<float>(step) / 7.f) < 1e-3);
+        }
+    }
+
+    SECTION("Append to the file") {
+        {
+            Trajectory file("tmp-compressed.chfl", "a");
+            auto frame = make_frame(100);
+            frame.velocities().clear();
+            file << frame;
+            file << make_frame(101);
+        }
+        Trajectory file("tmp-compressed.chfl");
+        CHECK(file.nsteps() == 102);
+        CHECK_FALSE(file.read_step(100).has_velocities());
+        CHECK(file.read_step(101).positions()[2] == Vector3D(101, 2, 0.5f));
+        CHECK(file.read_step(99).positions()[2] == Vector3D(99, 2, 0.5f));
+    }
+
+    SECTION("Recover the file") {
+        std::string content;
+        {
+            std::ifstream file("tmp-compressed.chfl", std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        // Remove the index and the end of the last frame
+        content.resize(content.size() - 100 * 8 - 3);
+        for (size_t i=40; i<48; i++) {
+            content[i] = 0;
+        }
+        {
+            std::ofstream file("tmp-compressed.chfl", std::ios::binary);
+            file << content;
+        }
+
+        Trajectory file("tmp-compressed.chfl");
+        CHECK(file.nsteps() == 99);
+        CHECK(file.read_step(98).positions()[1] == Vector3D(98, 1, 0.5f));
+    }
+
+    SECTION("Errors") {
+        Trajectory file("tmp-compressed.chfl", "a");
+        CHECK_THROWS_AS(file.option("precision", 1e-2), FormatError);
+        CHECK_THROWS_AS(file.option("compression", 1), FormatError);
+
+        auto frame = make_frame(0);
+        frame.positions()[0] = Vector3D(1e8f, 0, 0);
+        CHECK_THROWS_AS(file.write(frame), FormatError);
+        // The next frame is still written correctly
+        file << make_frame(100);
+    }
+
+    // Other formats do not have options
+    {
+        Trajectory file("tmp-compressed.xyz", "w");
+        CHECK_THROWS_AS(file.option("precision", 1e-3), FormatError);
+    }
+
+    remove("tmp-compressed.chfl");
+    remove("tmp-compressed.xyz");
+}
+
+TEST_CASE("Empty chemfiles binary files", "[Binary]"){
+    {
+        Trajectory file("tmp-empty.chfl", "w");
+    }
+    Trajectory file("tmp-empty.chfl");
+    CHECK(file.nsteps() == 0);
+
+    std::ofstream("tmp-not-binary.chfl") << "Hello world, this is not a chemfiles binary file, but it is long enough";
+    CHECK_THROWS_AS(Trajectory("tmp-not-binary.chfl"), FormatError);
+
+    remove("tmp-empty.chfl");
+    remove("tmp-not-binary.chfl");
+}
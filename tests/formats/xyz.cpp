@@ -1,6 +1,7 @@
 #include <streambuf>
 #include <fstream>
 #include <cstdio>
+#include <cmath>
 
 #include "catch.hpp"
 #include "chemfiles.hpp"
@@ -152,3 +153,107 @@ TEST_CASE("Write files in XYZ format", "[XYZ]"){
 
     remove("test-tmp.xyz");
 }
+
+TEST_CASE("Write files in XYZ format with a given precision", "[XYZ]"){
+    Topology topology;
+    topology.append(Atom("C"));
+    topology.append(Atom(""));
+
+    Frame frame;
+    frame.topology(topology);
+    frame.resize(2);
+    frame.positions()[0] = Vector3D(1.23456789f, -0.5f, 1e-7f);
+    frame.positions()[1] = Vector3D(-1234.5f, 1e25f, -0.0000001f);
+
+    {
+        auto file = Trajectory("test-tmp.xyz", "w");
+        file << frame;
+        file.option("precision", 2);
+        file << frame;
+        CHECK_THROWS_AS(file.option("precision", 1.5), FormatError);
+        CHECK_THROWS_AS(file.option("precision", -1), FormatError);
+        CHECK_THROWS_AS(file.option("precision", 10), FormatError);
+        CHECK_THROWS_AS(file.option("decimals", 2), FormatError);
+
+        // Large values are written with the slow path
+        file.option("precision", 9);
+        frame.positions()[0] = Vector3D(2e9f, 2.5e9f, -0.25f);
+        file << frame;
+    }
+
+    std::ifstream checking("test-tmp.xyz");
+    std::string content((std::istreambuf_iterator<char>(checking)),
+                         std::istreambuf_iterator<char>());
+    CHECK(content ==
+        "2\n"
+        "Written by the chemfiles library\n"
+        "C 1.23457 -0.5 0\n"
+        "X -1234.5 9999999562023526247432192 0\n"
+        "2\n"
+        "Written by the chemfiles library\n"
+        "C 1.23 -0.5 0\n"
+        "X -1234.5 9999999562023526247432192 0\n"
+        "2\n"
+        "Written by the chemfiles library\n"
+        "C 2000000000 2500000000 -0.25\n"
+        "X -1234.5 9999999562023526247432192 -0.0000001\n"
+    );
+
+    // The file can be read again
+    auto file = Trajectory("test-tmp.xyz");
+    auto positions = file.read().positions();
+    CHECK(std::fabs(positions[0][0] - 1.23457f) < 1e-6);
+    CHECK(positions[1][0] == -1234.5f);
+
+    remove("test-tmp.xyz");
+}
+
+TEST_CASE("Read a selection of atoms in XYZ format", "[XYZ]"){
+    {
+        std::ofstream file("test-selection.xyz");
+        file << "5\n\n"
+             << "O 0 0 0\n"
+             << "H 1 0 0\n"
+             << "H 2 0 0\n"
+             << "C 3 0 0\n"
+             << "N 4 0 0\n";
+    }
+
+    auto file = Trajectory("test-selection.xyz");
+    file.selection({4, 1, 3, 1});
+    CHECK(file.selection() == std::vector<size_t>({1, 3, 4}));
+
+    auto frame = file.read_step(0);
+    REQUIRE(frame.natoms() == 3);
+    CHECK(frame.positions()[0] == Vector3D(1, 0, 0));
+    CHECK(frame.positions()[2] == Vector3D(4, 0, 0));
+    CHECK(frame.topology().natoms() == 3);
+    CHECK(frame.topology()[1].name() == "C");
+
+    // The selection is also used with a custom topology
+    Topology topology;
+    topology.append(Atom("Zn"));
+    topology.append(Atom("Fe"));
+    topology.append(Atom("Cu"));
+    topology.append(Atom("Ag"));
+    topology.append(Atom("Au"));
+    topology.add_bond(1, 3);
+    topology.add_bond(0, 1);
+    file.topology(topology);
+
+    frame = file.read_step(0);
+    CHECK(frame.topology().natoms() == 3);
+    CHECK(frame.topology()[0].name() == "Fe");
+    CHECK(frame.topology()[2].name() == "Au");
+    CHECK(frame.topology().isbond(0, 1));
+    CHECK(frame.topology().bonds().size() == 1);
+
+    file.selection({2, 12});
+    CHECK_THROWS_AS(file.read_step(0), FormatError);
+
+    file.selection({});
+    frame = file.read_step(0);
+    CHECK(frame.natoms() == 5);
+
+    remove("test-selection.xyz");
+}
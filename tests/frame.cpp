@@ -10,6 +10,11 @@ TEST_CASE("Frame class usage", "[Frame]"){
     SECTION("Contructor"){
         CHECK(frame.positions().capacity() == 10);
         CHECK(frame.cell().type() == UnitCell::INFINITE);
+
+        auto with_topology = Frame(dummy_topology(4), true);
+        CHECK(with_topology.natoms() == 4);
+        CHECK(with_topology.topology().natoms() == 4);
+        CHECK(with_topology.has_velocities());
     }
 
     SECTION("Get and set"){
@@ -65,6 +70,52 @@ TEST_CASE("Frame class usage", "[Frame]"){
         }
     }
 
+    SECTION("Shared topology"){
+        Frame first;
+        auto& reference = first.topology();
+        reference.append(Atom("H"));
+        const Frame copy = first;
+        const Frame& const_first = first;
+        // The topology of the first frame can still be modified through
+        // `reference`, so the copy gets its own topology
+        CHECK(&copy.topology() != &const_first.topology());
+        reference.append(Atom("O"));
+        CHECK(first.topology().natoms() == 2);
+        CHECK(copy.topology().natoms() == 1);
+
+        Frame assigned;
+        assigned = first;
+        reference.append(Atom("N"));
+        CHECK(assigned.topology().natoms() == 2);
+
+        // Topologies set from a shared pointer are shared with the copies
+        auto topology = copy.shared_topology();
+        Frame other;
+        other.topology(topology);
+        CHECK(&other.shared_topology()->operator[](0) == &(*topology)[0]);
+        const Frame shared = other;
+        CHECK(shared.shared_topology() == topology);
+        assigned = other;
+        CHECK(assigned.shared_topology() == topology);
+        other.topology().append(Atom("C"));
+        CHECK(topology->natoms() == 1);
+        CHECK(other.topology().natoms() == 2);
+
+        // Const topologies are never modified, even when they are only used
+        // by one frame
+        auto constant = std::make_shared<const Topology>(3);
+        auto address = constant.get();
+        other.topology(std::move(constant));
+        other.topology().append(Atom("N"));
+        CHECK(&other.topology() != address);
+        CHECK(other.topology().natoms() == 4);
+        auto& modifiable = other.topology();
+        other.topology().append(Atom("S"));
+        CHECK(&other.topology() == &modifiable);
+
+        CHECK_THROWS_AS(other.topology(std::shared_ptr<const Topology>()), Error);
+    }
+
     SECTION("Errors"){
         auto mat = new float[3][3];
 
@@ -101,4 +152,18 @@ TEST_CASE("Frame class usage", "[Frame]"){
 
         CHECK(topology.bonds().size() == 4);
     }
+
+    SECTION("Guess bonds in small cells"){
+        auto topology = Topology();
+        topology.append(Atom("Si"));
+        topology.append(Atom("Si"));
+        auto silicon = Frame(topology);
+        silicon.positions()[1] = Vector3D(1.3575f, 1.3575f, 1.3575f);
+        // The cell is smaller than twice the bond guessing cutoff
+        silicon.cell(UnitCell(5.43));
+
+        silicon.guess_topology(true);
+        CHECK(silicon.topology().bonds().size() == 1);
+        CHECK(silicon.topology().isbond(0, 1));
+    }
 }
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "catch.hpp"
 #include "chemfiles/Logger.hpp"
@@ -110,3 +112,58 @@ TEST_CASE("Set the log level", "[logging]"){
     }
     std::clog.rdbuf(sbuf);
 }
+
+TEST_CASE("Disabled levels are not evaluated", "[logging]"){
+    Logger::level(Logger::WARNING);
+    size_t calls = 0;
+    auto count = [&calls](){calls++; return "message";};
+
+    std::stringstream out_buffer;
+    std::streambuf *sbuf = std::clog.rdbuf();
+    std::clog.rdbuf(out_buffer.rdbuf());
+
+    LOG(DEBUG) << count() << std::endl;
+    CHECK(calls == 0);
+    LOG(WARNING) << count() << std::endl;
+    CHECK(calls == 1);
+    CHECK("Chemfiles warning: message\n" == out_buffer.str());
+
+    // The macro can be used as the body of an if/else without braces
+    bool condition = calls == 0;
+    if (condition)
+        LOG(WARNING) << "not this one" << std::endl;
+    else
+        LOG(WARNING) << count() << std::endl;
+    CHECK(calls == 2);
+
+    std::clog.rdbuf(sbuf);
+}
+
+TEST_CASE("Log from multiple threads", "[logging]"){
+    Logger::level(Logger::WARNING);
+    std::stringstream out_buffer;
+    std::streambuf *sbuf = std::clog.rdbuf();
+    std::clog.rdbuf(out_buffer.rdbuf());
+
+    std::vector<std::thread> threads;
+    for (size_t i=0; i<4; i++) {
+        threads.emplace_back([i](){
+            for (size_t j=0; j<100; j++) {
+                LOG(WARNING) << "thread " << i << " " << "message " << j << std::endl;
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    std::clog.rdbuf(sbuf);
+
+    size_t nlines = 0;
+    std::string line;
+    while (std::getline(out_buffer, line)) {
+        CHECK(line.find("Chemfiles warning: thread ") == 0);
+        CHECK(line.find(" message ") != std::string::npos);
+        nlines++;
+    }
+    CHECK(nlines == 400);
+}
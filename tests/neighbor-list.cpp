@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <set>
+#include <tuple>
+
+#include "catch.hpp"
+#include "chemfiles.hpp"
+#include "chemfiles/NeighborList.hpp"
+using namespace chemfiles;
+
+typedef std::set<std::pair<size_t, size_t>> pair_set;
+
+static Frame random_frame(size_t natoms, const UnitCell& cell, float size) {
+    auto frame = Frame(natoms);
+    frame.cell(cell);
+    for (auto& position: frame.positions()) {
+        for (size_t k=0; k<3; k++) {
+            position[k] = size * static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+        }
+    }
+    return frame;
+}
+
+// Get all the pairs closer than the cutoff, wrapping the distances in the cell
+static pair_set brute_force(const Frame& frame, double cutoff) {
+    pair_set pairs;
+    auto& positions = frame.positions();
+    for (size_t i=0; i<frame.natoms(); i++) {
+        for (size_t j=i+1; j<frame.natoms(); j++) {
+            if (norm(frame.cell().wrap(positions[j] - positions[i])) < cutoff) {
+                pairs.insert({i, j});
+            }
+        }
+    }
+    return pairs;
+}
+
+static pair_set as_set(const NeighborList& list) {
+    pair_set pairs;
+    for (auto& pair: list.pairs()) {
+        CHECK(pair.i < pair.j);
+        pairs.insert({pair.i, pair.j});
+    }
+    CHECK(pairs.size() == list.pairs().size());
+    return pairs;
+}
+
+TEST_CASE("Neighbor list", "[NeighborList]"){
+    std::srand(42);
+
+    SECTION("Infinite cell"){
+        auto frame = random_frame(500, UnitCell(), 20);
+        auto list = NeighborList(2.5);
+        list.compute(frame);
+        CHECK(as_set(list) == brute_force(frame, 2.5));
+    }
+
+    SECTION("Orthorombic cell"){
+        auto frame = random_frame(1000, UnitCell(20, 22, 25), 20);
+        auto list = NeighborList(3.0);
+        list.compute(frame);
+        CHECK(as_set(list) == brute_force(frame, 3.0));
+
+        for (auto& pair: list.pairs()) {
+            auto& positions = frame.positions();
+            auto distance = norm(frame.cell().wrap(positions[pair.i] - positions[pair.j]));
+            CHECK(fabs(pair.distance - distance) < 1e-4);
+        }
+    }
+
+    SECTION("Triclinic cell"){
+        auto frame = random_frame(800, UnitCell(20, 20, 20, 90, 90, 110), 15);
+        auto list = NeighborList(2.5);
+        list.compute(frame);
+        CHECK(as_set(list) == brute_force(frame, 2.5));
+    }
+
+    SECTION("Partial periodicity"){
+        auto frame = random_frame(500, UnitCell(15), 15);
+        frame.cell().periodic_z(false);
+        auto list = NeighborList(2.0);
+        list.compute(frame);
+
+        auto periodic = frame;
+        periodic.cell().periodic_z(true);
+        auto all_pairs = brute_force(periodic, 2.0);
+        auto pairs = as_set(list);
+        for (auto& pair: all_pairs) {
+            auto dz = periodic.positions()[pair.first][2] - periodic.positions()[pair.second][2];
+            if (fabs(dz) < 7.5) {
+                CHECK(pairs.count(pair) == 1);
+            } else {
+                CHECK(pairs.count(pair) == 0);
+            }
+        }
+    }
+
+    SECTION("Selection"){
+        auto frame = random_frame(500, UnitCell(15), 15);
+        std::vector<size_t> selection;
+        for (size_t i=0; i<500; i+=3) {
+            selection.push_back(i);
+        }
+
+        auto list = NeighborList(2.5);
+        list.compute(frame, selection);
+        auto pairs = as_set(list);
+        for (auto& pair: brute_force(frame, 2.5)) {
+            bool selected = pair.first % 3 == 0 && pair.second % 3 == 0;
+            CHECK(pairs.count(pair) == (selected ? 1u : 0u));
+        }
+    }
+
+    SECTION("Verlet list updates"){
+        auto frame = random_frame(1000, UnitCell(20), 20);
+        auto list = NeighborList(2.5, 1.0);
+        list.compute(frame);
+        CHECK(list.rebuilds() == 1);
+
+        // Small displacements do not trigger a rebuild
+        for (auto& position: frame.positions()) {
+            position = position + Vector3D(0.1f, -0.2f, 0.1f);
+        }
+        list.update(frame);
+        CHECK(list.rebuilds() == 1);
+        CHECK(as_set(list) == brute_force(frame, 2.5));
+
+        frame.positions()[0] = frame.positions()[0] + Vector3D(0.6f, 0, 0);
+        list.update(frame);
+        CHECK(list.rebuilds() == 2);
+        CHECK(as_set(list) == brute_force(frame, 2.5));
+
+        frame.cell(UnitCell(21));
+        list.update(frame);
+        CHECK(list.rebuilds() == 3);
+    }
+
+    SECTION("Threads"){
+        auto frame = random_frame(20000, UnitCell(60), 60);
+        auto serial = NeighborList(3.0);
+        serial.threads(1);
+        serial.compute(frame);
+
+        auto parallel = NeighborList(3.0);
+        parallel.threads(4);
+        CHECK(parallel.threads() == 4);
+        parallel.compute(frame);
+        CHECK(as_set(serial) == as_set(parallel));
+    }
+
+    SECTION("Errors"){
+        CHECK_THROWS_AS(NeighborList(-1), Error);
+        CHECK_THROWS_AS(NeighborList(2, -1), Error);
+
+        auto frame = random_frame(10, UnitCell(5), 5);
+        auto list = NeighborList(3.0);
+        CHECK_FALSE(list.fits(UnitCell(5)));
+        CHECK(list.fits(UnitCell(10)));
+        CHECK(list.fits(UnitCell()));
+        CHECK_THROWS_AS(list.compute(frame), Error);
+        CHECK(list.rebuilds() == 0);
+
+        frame.cell(UnitCell(10));
+        CHECK_THROWS_AS(list.compute(frame, {3, 42}), Error);
+        CHECK(list.rebuilds() == 0);
+
+        // Failed updates leave the list unchanged
+        list.compute(frame);
+        CHECK(list.rebuilds() == 1);
+        auto pairs = as_set(list);
+        frame.cell(UnitCell(5));
+        CHECK_THROWS_AS(list.update(frame), Error);
+        CHECK(list.rebuilds() == 1);
+        CHECK(as_set(list) == pairs);
+    }
+}
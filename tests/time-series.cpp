@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <fstream>
+
+#include "catch.hpp"
+#include "chemfiles.hpp"
+using namespace chemfiles;
+
+TEST_CASE("Transpose trajectories to time series", "[TimeSeries]"){
+    {
+        Trajectory file("tmp-series.xyz", "w");
+        Topology topology;
+        for (size_t i=0; i<4; i++) {
+            topology.append(Atom("Ar"));
+        }
+        for (size_t step=0; step<10; step++) {
+            Frame frame;
+            frame.topology(topology);
+            frame.resize(4);
+            for (size_t i=0; i<4; i++) {
+                frame.positions()[i] = Vector3D(static_cast<float>(step), static_cast<float>(i), -0.5f);
+            }
+            file << frame;
+        }
+    }
+
+    SECTION("All the atoms") {
+        {
+            Trajectory file("tmp-series.xyz");
+            // Use a tile which does not divide the number of steps
+            TimeSeries::transpose(file, "tmp-series.chts", 3);
+        }
+        TimeSeries series("tmp-series.chts");
+        CHECK(series.natoms() == 4);
+        CHECK(series.nsteps() == 10);
+
+        auto positions = series.positions(2);
+        REQUIRE(positions.size() == 10);
+        for (size_t step=0; step<10; step++) {
+            CHECK(positions[step] == Vector3D(static_cast<float>(step), 2, -0.5f));
+        }
+
+        series.positions(0, positions);
+        CHECK(positions[7] == Vector3D(7, 0, -0.5f));
+
+        CHECK_THROWS_AS(series.positions(4), Error);
+    }
+
+    SECTION("Selection of atoms") {
+        {
+            Trajectory file("tmp-series.xyz");
+            file.selection({3, 1});
+            TimeSeries::transpose(file, "tmp-series.chts");
+        }
+        TimeSeries series("tmp-series.chts");
+        CHECK(series.natoms() == 2);
+        CHECK(series.positions(1)[4] == Vector3D(4, 3, -0.5f));
+    }
+
+    SECTION("Errors") {
+        Trajectory file("tmp-series.xyz");
+        CHECK_THROWS_AS(TimeSeries::transpose(file, "tmp-series.chts", 0), Error);
+        CHECK_THROWS_AS(TimeSeries("tmp-series.xyz"), FormatError);
+        CHECK_THROWS_AS(TimeSeries("not-here.chts"), FileError);
+    }
+
+    remove("tmp-series.xyz");
+    remove("tmp-series.chts");
+}
@@ -61,6 +61,23 @@ TEST_CASE("Use the Topology class", "[Topology]"){
         CHECK(topo.dihedrals().size() == 1);
         CHECK(topo.isdihedral(2, 5, 3, 6));
 
+        CHECK(topo.nbonds() == 5);
+        CHECK(topo.nangles() == 3);
+        CHECK(topo.ndihedrals() == 1);
+
+        size_t bonds[5][2];
+        topo.raw_bonds(bonds, 5);
+        auto expected = topo.bonds();
+        for (size_t i=0; i<5; i++) {
+            CHECK(bonds[i][0] == expected[i][0]);
+            CHECK(bonds[i][1] == expected[i][1]);
+        }
+        size_t dihedrals[1][4];
+        topo.raw_dihedrals(dihedrals, 1);
+        CHECK(dihedral(dihedrals[0][0], dihedrals[0][1], dihedrals[0][2], dihedrals[0][3]) == dihedral(2, 5, 3, 6));
+        size_t angles[2][3];
+        CHECK_THROWS_AS(topo.raw_angles(angles, 2), MemoryError);
+
         topo.remove(6);
         CHECK(topo.natoms() == 6);
         CHECK(topo.bonds().size() == 4);
@@ -74,4 +91,45 @@ TEST_CASE("Use the Topology class", "[Topology]"){
         CHECK_FALSE(topo.isbond(1, 4));
         CHECK_FALSE(topo.isangle(0, 4, 1));
     }
+
+    SECTION("Atom templates"){
+        auto topo = Topology();
+        for (size_t i=0; i<1000; i++) {
+            auto atom = Atom("X" + std::to_string(i % 100));
+            atom.charge(static_cast<float>(i % 3));
+            topo.append(atom);
+        }
+        CHECK(topo.natoms() == 1000);
+        CHECK(topo.natom_types() == 300);
+        CHECK(topo[101].name() == "X1");
+        CHECK(topo[101].charge() == 2);
+
+        // Modifying a template through operator[] modifies all the
+        // corresponding atoms, and the next appended atoms use the new value
+        topo[0].name("Y");
+        CHECK(topo[300].name() == "Y");
+        topo.append(Atom("X0"));
+        CHECK(topo.natom_types() == 301);
+        CHECK(topo[1000].name() == "X0");
+        topo.append(Atom("Y"));
+        CHECK(topo[1001].name() == "Y");
+
+        topo.clear();
+        CHECK(topo.natom_types() == 0);
+        topo.append(Atom("X0"));
+        CHECK(topo.natom_types() == 1);
+    }
+
+    SECTION("Bulk append"){
+        auto atoms = std::vector<Atom>{Atom("H"), Atom("O"), Atom("H")};
+        auto topo = Topology();
+        topo.reserve(3);
+        CHECK(topo.natoms() == 0);
+        CHECK(topo._atoms.capacity() >= 3);
+
+        topo.append(atoms.begin(), atoms.end());
+        CHECK(topo.natoms() == 3);
+        CHECK(topo.natom_types() == 2);
+        CHECK(topo[2].name() == "H");
+    }
 }
@@ -100,3 +100,138 @@ TEST_CASE("Specify a format parameter", "[Trajectory]"){
     file >> frame;
     CHECK(frame.natoms() == 125);
 }
+
+static void write_steps(const std::string& path, size_t first, size_t last) {
+    Topology topology;
+    topology.append(Atom("Zn"));
+    topology.append(Atom("Cu"));
+
+    Trajectory file(path, "w");
+    for (size_t step=first; step<last; step++) {
+        Frame frame;
+        frame.topology(topology);
+        frame.resize(2);
+        frame.positions()[0] = Vector3D(static_cast<float>(step), 0, 0);
+        frame.positions()[1] = Vector3D(static_cast<float>(step), 1, 0);
+        file << frame;
+    }
+}
+
+TEST_CASE("Read multiple files as a single trajectory", "[Trajectory]"){
+    write_steps("tmp-multi.part1.xyz", 0, 2);
+    write_steps("tmp-multi.part2.xyz", 2, 5);
+    write_steps("tmp-multi.part3.chfl", 5, 5);
+    write_steps("tmp-multi.part4.chfl", 5, 6);
+    auto paths = std::vector<std::string>{
+        "tmp-multi.part1.xyz", "tmp-multi.part2.xyz", "tmp-multi.part3.chfl", "tmp-multi.part4.chfl"
+    };
+
+    SECTION("List of files") {
+        Trajectory file(paths);
+        CHECK(file.nsteps() == 6);
+        for (size_t step=0; step<6; step++) {
+            auto frame = file.read();
+            CHECK(frame.natoms() == 2);
+            CHECK(frame.positions()[1] == Vector3D(static_cast<float>(step), 1, 0));
+        }
+        CHECK(file.done());
+
+        CHECK(file.read_step(3).positions()[0] == Vector3D(3, 0, 0));
+        CHECK(file.read_step(0).positions()[0] == Vector3D(0, 0, 0));
+        CHECK(file.read().positions()[0] == Vector3D(1, 0, 0));
+
+        // Keep a single file open
+        file.option("max_open_files", 1);
+        CHECK(file.read_step(5).positions()[0] == Vector3D(5, 0, 0));
+        CHECK(file.read_step(4).positions()[0] == Vector3D(4, 0, 0));
+        CHECK(file.read_step(1).positions()[0] == Vector3D(1, 0, 0));
+
+        file.selection({1});
+        auto frame = file.read_step(2);
+        CHECK(frame.natoms() == 1);
+        CHECK(frame.topology()[0].name() == "Cu");
+    }
+
+    SECTION("Glob pattern") {
+        Trajectory file("tmp-multi.part*.xyz");
+        CHECK(file.nsteps() == 5);
+        CHECK(file.read_step(4).positions()[0] == Vector3D(4, 0, 0));
+
+        file = Trajectory("tmp-multi.part[34].chfl");
+        CHECK(file.nsteps() == 1);
+    }
+
+    SECTION("Errors") {
+        CHECK_THROWS_AS(Trajectory("tmp-multi.not-here*.xyz"), FileError);
+        CHECK_THROWS_AS(Trajectory(std::vector<std::string>()), FileError);
+        CHECK_THROWS_AS(Trajectory(std::vector<std::string>{"tmp-multi.part1.xyz", "not-here.xyz"}), FileError);
+
+        Trajectory file(paths);
+        CHECK_THROWS_AS(file.option("max_open_files", 0), FormatError);
+        CHECK_THROWS_AS(file.option("max_open_files", 2.5), FormatError);
+        CHECK_THROWS_AS(file.read_step(6), FileError);
+    }
+
+    for (auto& path: paths) {
+        remove(path.c_str());
+    }
+}
+
+TEST_CASE("Trajectory counters", "[Trajectory]"){
+    write_steps("tmp-counters.xyz", 0, 6);
+    Trajectory file("tmp-counters.xyz");
+    CHECK(file.counters().frames_read == 0);
+    file.read();
+    // The counters are disabled by default
+    CHECK(file.counters().frames_read == 0);
+    CHECK(file.counters().bytes_read == 0);
+
+    file.enable_counters();
+    file.read();
+    file.read_block(2, 5, 1);
+    auto counters = file.counters();
+    CHECK(counters.frames_read == 4);
+    CHECK(counters.frames_written == 0);
+    CHECK(counters.bytes_read > 0);
+    CHECK(counters.file_time >= 0);
+    CHECK(counters.format_time >= 0);
+    CHECK(counters.post_processing_time >= 0);
+
+    std::stringstream out_buffer;
+    std::streambuf *sbuf = std::clog.rdbuf();
+    std::clog.rdbuf(out_buffer.rdbuf());
+    auto level = Logger::level();
+    Logger::level(Logger::INFO);
+    file.log_counters();
+    Logger::level(level);
+    std::clog.rdbuf(sbuf);
+    CHECK(out_buffer.str().find("4 frames read") != std::string::npos);
+
+    Trajectory output("tmp-counters-output.xyz", "w");
+    output.enable_counters();
+    output << file.read_step(0);
+    CHECK(output.counters().frames_written == 1);
+
+    remove("tmp-counters.xyz");
+    remove("tmp-counters-output.xyz");
+}
+
+TEST_CASE("Read blocks of steps", "[Trajectory]"){
+    write_steps("tmp-block.xyz", 0, 10);
+    Trajectory file("tmp-block.xyz");
+
+    std::vector<Frame> frames;
+    file.read_block(1, 10, 3, frames);
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[0].positions()[0][0] == 1);
+    CHECK(frames[1].positions()[0][0] == 4);
+    CHECK(frames[2].positions()[0][0] == 7);
+
+    frames = file.read_block(5, 8);
+    REQUIRE(frames.size() == 3);
+    for (size_t i=0; i<3; i++) {
+        CHECK(frames[i].positions()[1][0] == 5 + i);
+    }
+
+    remove("tmp-block.xyz");
+}